@@ -0,0 +1,275 @@
+#ifndef INDEXBUFFER_HPP
+#define INDEXBUFFER_HPP
+
+/**
+ * @file IndexBuffer.hpp
+ * @brief Small-buffer vector of indices used for MyContainer's permutations.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <algorithm>
+#include <utility>
+
+namespace ariel {
+namespace detail {
+
+/**
+ * @class RecyclingResource
+ * @brief Global-heap resource that keeps freed blocks in thread-local free lists.
+ *
+ * Requests are rounded up to a power-of-two size class (64 B .. 256 KiB) and
+ * served from the calling thread's free list when possible, so repeatedly
+ * building orders of similar size stops allocating after the first build.
+ * Blocks are plain ::operator new memory, so a block freed on another thread
+ * simply joins that thread's list. Each list keeps at most kKeepPerClass blocks
+ * and a thread retains at most kMaxRetainedBytes in total; trim() hands the
+ * calling thread's blocks back to the heap. Larger or over-aligned requests go
+ * straight to the heap.
+ */
+class RecyclingResource : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t kMinShift = 6;       ///< Smallest class: 64 bytes.
+    static constexpr std::size_t kMaxShift = 18;      ///< Largest class: 256 KiB (32Ki indices).
+    static constexpr std::size_t kKeepPerClass = 4;   ///< Blocks retained per class and thread.
+    static constexpr std::size_t kMaxRetainedBytes = std::size_t(1) << 20;  ///< Per-thread cap: 1 MiB.
+
+    /// Frees every block retained by the calling thread.
+    static void trim() noexcept {
+        if (!destroyed()) lists().clear();
+    }
+
+    /// Bytes currently retained by the calling thread.
+    static std::size_t retained_bytes() noexcept {
+        return destroyed() ? 0 : lists().bytes;
+    }
+
+private:
+    struct Node { Node* next; };
+
+    struct FreeLists {
+        Node* head[kMaxShift + 1] = {};
+        std::size_t count[kMaxShift + 1] = {};
+        std::size_t bytes = 0;
+        void clear() noexcept {
+            for (std::size_t c = 0; c <= kMaxShift; ++c) {
+                while (Node* h = head[c]) {
+                    head[c] = h->next;
+                    ::operator delete(h);
+                }
+                count[c] = 0;
+            }
+            bytes = 0;
+        }
+        ~FreeLists() {
+            clear();
+            destroyed() = true;
+        }
+    };
+
+    // Set once this thread's lists are gone, so late frees bypass them.
+    static bool& destroyed() noexcept {
+        thread_local bool flag = false;
+        return flag;
+    }
+
+    static FreeLists& lists() noexcept {
+        thread_local FreeLists l;
+        return l;
+    }
+
+    // Size class of a request, or 0 when it is not pooled.
+    static std::size_t classOf(std::size_t bytes, std::size_t align) noexcept {
+        if (align > alignof(std::max_align_t) || bytes > (std::size_t(1) << kMaxShift)) return 0;
+        std::size_t shift = kMinShift;
+        while ((std::size_t(1) << shift) < bytes) ++shift;
+        return shift;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        const std::size_t c = classOf(bytes, align);
+        if (c == 0) return std::pmr::new_delete_resource()->allocate(bytes, align);
+        if (!destroyed()) {
+            FreeLists& l = lists();
+            if (Node* n = l.head[c]) {
+                l.head[c] = n->next;
+                --l.count[c];
+                l.bytes -= std::size_t(1) << c;
+                return n;
+            }
+        }
+        return ::operator new(std::size_t(1) << c);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        const std::size_t c = classOf(bytes, align);
+        if (c == 0) return std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+        if (!destroyed()) {
+            FreeLists& l = lists();
+            if (l.count[c] < kKeepPerClass && l.bytes + (std::size_t(1) << c) <= kMaxRetainedBytes) {
+                l.head[c] = new (p) Node{l.head[c]};
+                ++l.count[c];
+                l.bytes += std::size_t(1) << c;
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+        return this == &o;
+    }
+};
+
+// Shared instance; its state is thread-local, so it needs no locking.
+inline RecyclingResource* recyclingResource() noexcept {
+    static RecyclingResource instance;
+    return &instance;
+}
+
+// Permutation and scratch buffers that would hit the global heap are recycled instead.
+inline std::pmr::memory_resource* bufferResource(std::pmr::memory_resource* r) noexcept {
+    return r == std::pmr::new_delete_resource() ? recyclingResource() : r;
+}
+
+/**
+ * @class IndexBuffer
+ * @brief Vector of std::size_t that keeps up to kInline entries inside the object.
+ *
+ * Orders of tiny containers therefore live on the stack (inside the iterator)
+ * and never touch the heap; larger orders spill to a block obtained from the
+ * buffer's memory resource (the RecyclingResource when that would be the
+ * global heap). Copies share the source's resource; moves carry their block
+ * (and its resource) along.
+ */
+class IndexBuffer {
+public:
+    static constexpr std::size_t kInline = 16;  ///< Entries stored without allocating.
+
+    explicit IndexBuffer(std::pmr::memory_resource* r = std::pmr::get_default_resource()) noexcept
+        : ptr(local), len(0), cap(kInline), res(bufferResource(r)) {}
+
+    explicit IndexBuffer(std::size_t n,
+                         std::pmr::memory_resource* r = std::pmr::get_default_resource())
+        : IndexBuffer(r) { resize(n); }
+
+    IndexBuffer(const IndexBuffer& o) : IndexBuffer(o.res) {
+        resize(o.len);
+        std::copy(o.ptr, o.ptr + o.len, ptr);
+    }
+
+    IndexBuffer(IndexBuffer&& o) noexcept : IndexBuffer(o.res) { steal(o); }
+
+    IndexBuffer& operator=(const IndexBuffer& o) {
+        if (this != &o) {
+            resize(o.len);
+            std::copy(o.ptr, o.ptr + o.len, ptr);
+        }
+        return *this;
+    }
+
+    IndexBuffer& operator=(IndexBuffer&& o) noexcept {
+        if (this != &o) {
+            release();
+            steal(o);
+        }
+        return *this;
+    }
+
+    ~IndexBuffer() { release(); }
+
+    std::pmr::memory_resource* resource() const noexcept { return res; }
+    std::size_t size() const noexcept { return len; }
+    bool empty() const noexcept { return len == 0; }
+    std::size_t* data() noexcept { return ptr; }
+    const std::size_t* data() const noexcept { return ptr; }
+    std::size_t* begin() noexcept { return ptr; }
+    std::size_t* end() noexcept { return ptr + len; }
+    const std::size_t* begin() const noexcept { return ptr; }
+    const std::size_t* end() const noexcept { return ptr + len; }
+    std::size_t& operator[](std::size_t i) noexcept { return ptr[i]; }
+    std::size_t operator[](std::size_t i) const noexcept { return ptr[i]; }
+    std::size_t back() const noexcept { return ptr[len - 1]; }
+
+    // Bounds-checked access, mirroring std::vector::at().
+    std::size_t at(std::size_t i) const {
+        if (i >= len) throw std::out_of_range("IndexBuffer::at");
+        return ptr[i];
+    }
+
+    // Grows capacity to at least n, keeping contents.
+    void reserve(std::size_t n) {
+        if (n <= cap) return;
+        std::size_t* p = allocate(n);
+        std::copy(ptr, ptr + len, p);
+        const std::size_t keep = len;
+        release();
+        ptr = p;
+        len = keep;
+        cap = n;
+    }
+
+    // New entries are left uninitialised; callers overwrite them.
+    void resize(std::size_t n) {
+        reserve(n);
+        len = n;
+    }
+
+    void push_back(std::size_t v) {
+        if (len == cap) reserve(cap * 2);
+        ptr[len++] = v;
+    }
+
+    void clear() noexcept { len = 0; }
+
+    void swap(IndexBuffer& o) noexcept {
+        IndexBuffer tmp(std::move(o));
+        o = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    std::size_t* ptr;             ///< local or a heap block.
+    std::size_t len;              ///< Number of entries in use.
+    std::size_t cap;              ///< Entries available at ptr.
+    std::pmr::memory_resource* res;  ///< Source of heap blocks.
+    std::size_t local[kInline];   ///< Inline storage for small orders.
+
+    bool isLocal() const noexcept { return ptr == local; }
+
+    std::size_t* allocate(std::size_t n) {
+        return static_cast<std::size_t*>(res->allocate(n * sizeof(std::size_t), alignof(std::size_t)));
+    }
+
+    // Frees a heap block, leaving the buffer empty and inline.
+    void release() noexcept {
+        if (!isLocal()) res->deallocate(ptr, cap * sizeof(std::size_t), alignof(std::size_t));
+        ptr = local;
+        len = 0;
+        cap = kInline;
+    }
+
+    // Takes o's contents (and resource), leaving o empty; *this must be empty and inline.
+    void steal(IndexBuffer& o) noexcept {
+        res = o.res;
+        if (o.isLocal()) {
+            std::copy(o.local, o.local + o.len, local);
+        } else {
+            ptr = o.ptr;
+            cap = o.cap;
+            o.ptr = o.local;
+            o.cap = kInline;
+        }
+        len = o.len;
+        o.len = 0;
+    }
+};
+
+} // namespace detail
+} // namespace ariel
+
+#endif // INDEXBUFFER_HPP
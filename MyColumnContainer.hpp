@@ -0,0 +1,233 @@
+#ifndef MYCOLUMNCONTAINER_HPP
+#define MYCOLUMNCONTAINER_HPP
+
+/**
+ * @file MyColumnContainer.hpp
+ * @brief Structure-of-arrays companion to MyContainer for aggregate element types.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <vector>
+#include <tuple>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "SortEngine.hpp"
+
+namespace ariel {
+
+/**
+ * @struct field_traits
+ * @brief Field descriptor: lists the data members of T that form its columns.
+ *
+ * Specialise with `static constexpr auto fields = std::make_tuple(&T::a, &T::b, ...);`
+ * The listed members must fully describe T, which must be default-constructible.
+ */
+template<typename T>
+struct field_traits;
+
+namespace detail {
+
+template<typename M>
+struct member_type;
+template<typename C, typename F>
+struct member_type<F C::*> { using type = F; };
+
+template<typename T, typename Seq>
+struct columns_of;
+template<typename T, std::size_t... I>
+struct columns_of<T, std::index_sequence<I...>> {
+    using fields = std::remove_const_t<decltype(field_traits<T>::fields)>;
+    using type = std::tuple<std::vector<typename member_type<std::tuple_element_t<I, fields>>::type>...>;
+};
+
+} // namespace detail
+
+/**
+ * @class MyColumnContainer
+ * @brief Stores each field of T in its own contiguous column.
+ *
+ * @tparam T Aggregate with a field_traits specialisation; requires operator== and operator<<.
+ *
+ * Ordering by one field sorts and scans only that field's column. Iterators
+ * either reassemble the whole element (operator*) or hand out a single field
+ * (field<I>()), which touches only that column.
+ */
+template<typename T>
+class MyColumnContainer {
+public:
+    static constexpr std::size_t kFields =
+        std::tuple_size_v<std::remove_const_t<decltype(field_traits<T>::fields)>>;
+
+private:
+    using Indices = std::make_index_sequence<kFields>;
+    using Columns = typename detail::columns_of<T, Indices>::type;
+
+    Columns columns;  ///< One std::vector per field, all of equal length.
+
+    template<std::size_t... I>
+    void push(const T& elem, std::index_sequence<I...>) {
+        (std::get<I>(columns).push_back(elem.*std::get<I>(field_traits<T>::fields)), ...);
+    }
+
+    template<std::size_t... I>
+    T assemble(std::size_t i, std::index_sequence<I...>) const {
+        T elem{};
+        ((elem.*std::get<I>(field_traits<T>::fields) = std::get<I>(columns)[i]), ...);
+        return elem;
+    }
+
+    template<std::size_t... I>
+    void compact(const std::vector<bool>& keep, std::index_sequence<I...>) {
+        auto filter = [&](auto& col) {
+            std::size_t w = 0;
+            for (std::size_t r = 0; r < col.size(); ++r) {
+                if (keep[r]) col[w++] = std::move(col[r]);
+            }
+            col.resize(w);
+        };
+        (filter(std::get<I>(columns)), ...);
+    }
+
+public:
+    /// Type of the I-th field listed in field_traits<T>.
+    template<std::size_t I>
+    using field_type = typename std::tuple_element_t<I, Columns>::value_type;
+
+    /**
+     * @brief Add an element, scattering its fields into the columns.
+     * @param elem The element to add.
+     */
+    void addElement(const T& elem) { push(elem, Indices{}); }
+
+    /**
+     * @brief Remove all occurrences of an element.
+     * @param elem The element to remove.
+     * @throws std::runtime_error if the element is not found.
+     */
+    void removeElement(const T& elem) {
+        std::vector<bool> keep(size());
+        bool found = false;
+        for (std::size_t i = 0; i < size(); ++i) {
+            keep[i] = !(element(i) == elem);
+            found = found || !keep[i];
+        }
+        if (!found) throw std::runtime_error("Element not found");
+        compact(keep, Indices{});
+    }
+
+    /**
+     * @brief Get the number of elements in the container.
+     * @return Current size.
+     */
+    std::size_t size() const { return std::get<0>(columns).size(); }
+
+    /**
+     * @brief Reassemble the element at an insertion position.
+     * @param i Insertion position.
+     * @return Copy of the element.
+     * @throws std::out_of_range if i >= size().
+     */
+    T element(std::size_t i) const {
+        if (i >= size()) throw std::out_of_range("MyColumnContainer::element");
+        return assemble(i, Indices{});
+    }
+
+    /**
+     * @brief Read-only access to one column.
+     * @tparam I Field position in field_traits<T>::fields.
+     * @return The column, in insertion order.
+     */
+    template<std::size_t I>
+    const std::vector<field_type<I>>& column() const { return std::get<I>(columns); }
+
+    /**
+     * @brief Stream output operator; prints elements in insertion order, e.g. "[ a b c ]".
+     */
+    friend std::ostream& operator<<(std::ostream& os, const MyColumnContainer& cont) {
+        os << "[ ";
+        for (std::size_t i = 0; i < cont.size(); ++i) os << cont.element(i) << " ";
+        return os << "]";
+    }
+
+    class ColumnIterator;  ///< Walks a permutation (or insertion order) of the rows.
+
+    /**
+     * @brief Get iterator to beginning of insertion sequence.
+     * @return ColumnIterator at first element.
+     */
+    ColumnIterator begin_order() const { return ColumnIterator(this, 0); }
+
+    /**
+     * @brief Get iterator to end of insertion sequence.
+     * @return ColumnIterator one past last.
+     */
+    ColumnIterator end_order() const { return ColumnIterator(this, size()); }
+
+    /**
+     * @brief Get iterator to beginning of the sequence ascending by field I.
+     * @param comp Strict weak ordering on field values.
+     * @return ColumnIterator at first element; only column I is read to build the order.
+     */
+    template<std::size_t I, typename Compare = std::less<>>
+    ColumnIterator begin_ascending_by(Compare comp = {}) const {
+        ColumnIterator it(this, 0);
+        if (size() > 0) {
+            identity proj;
+            detail::sortIndices(std::get<I>(columns), it.order, comp, proj);
+            it.permuted = true;
+        }
+        return it;
+    }
+
+    /**
+     * @brief Get iterator to end of any field-ordered sequence.
+     * @return ColumnIterator one past last.
+     */
+    ColumnIterator end_ascending_by() const { return ColumnIterator(this, size()); }
+};
+
+template<typename T>
+class MyColumnContainer<T>::ColumnIterator {
+    friend class MyColumnContainer;
+
+    const MyColumnContainer* cont;
+    detail::IndexBuffer order;
+    bool permuted = false;
+    std::size_t index;
+
+    std::size_t row() const {
+        if (index >= cont->size()) throw std::out_of_range("ColumnIterator");
+        return permuted ? order[index] : index;
+    }
+
+public:
+    ColumnIterator(const MyColumnContainer* c, std::size_t i)
+        : cont(c), index(i) {}
+
+    ColumnIterator& operator++() { ++index; return *this; }
+    bool operator==(const ColumnIterator& o) const {
+        return cont==o.cont && index==o.index;
+    }
+    bool operator!=(const ColumnIterator& o) const { return !(*this==o); }
+
+    /// Reassembles the current element from every column.
+    T operator*() const { return cont->element(row()); }
+
+    /// Reads one field of the current element, touching only its column
+    /// (by value for bool fields, whose column is a std::vector<bool>).
+    template<std::size_t I>
+    typename std::vector<field_type<I>>::const_reference field() const {
+        return std::get<I>(cont->columns)[row()];
+    }
+
+    /// Insertion position of the current element.
+    std::size_t position() const { return row(); }
+};
+
+} // namespace ariel
+
+#endif // MYCOLUMNCONTAINER_HPP
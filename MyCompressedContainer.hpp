@@ -0,0 +1,222 @@
+#ifndef MYCOMPRESSEDCONTAINER_HPP
+#define MYCOMPRESSEDCONTAINER_HPP
+
+/**
+ * @file MyCompressedContainer.hpp
+ * @brief Duplicate-compressed variant of MyContainer for low-cardinality data.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include "SortEngine.hpp"
+
+namespace ariel {
+
+/**
+ * @class MyCompressedContainer
+ * @brief Stores each distinct value once, with its multiplicity.
+ *
+ * @tparam T The type of elements stored; requires operator< and operator==.
+ *
+ * Insertion order is kept as one 32-bit slot id per element, so a container
+ * that is mostly duplicates costs about 4 bytes per element plus one T per
+ * distinct value. The distinct values are kept sorted as they arrive, so the
+ * sorted traversals never sort: they expand the (value, multiplicity) runs,
+ * locating a rank by binary search over d run boundaries.
+ *
+ * Iterators return elements by value, as MyContainer's do, and are
+ * invalidated by addElement()/removeElement().
+ */
+template<typename T>
+class MyCompressedContainer {
+private:
+    std::vector<T> values;               ///< Distinct values, in order of first insertion.
+    std::vector<std::size_t> counts;     ///< counts[s]: copies of values[s].
+    std::vector<std::uint32_t> ids;      ///< ids[i]: slot of the i-th inserted element.
+    std::vector<std::uint32_t> byValue;  ///< Slots in ascending value order.
+
+    // First entry of byValue whose value is not less than x.
+    std::vector<std::uint32_t>::const_iterator lowerBound(const T& x) const {
+        return std::lower_bound(byValue.begin(), byValue.end(), x,
+                                [this](std::uint32_t s, const T& v) { return values[s] < v; });
+    }
+
+    enum class Mode { Ascending, Descending, SideCross, Reverse, Insertion, MiddleOut };
+
+public:
+    /**
+     * @brief Add an element to the container.
+     * @param elem The element to add.
+     * @throws std::length_error if elem would be the 2^32-th distinct value.
+     */
+    void addElement(const T& elem) {
+        auto pos = lowerBound(elem);
+        if (pos != byValue.end() && values[*pos] == elem) {
+            ++counts[*pos];
+            ids.push_back(*pos);
+            return;
+        }
+        if (values.size() == std::numeric_limits<std::uint32_t>::max()) {
+            throw std::length_error("MyCompressedContainer: too many distinct values");
+        }
+        const auto slot = static_cast<std::uint32_t>(values.size());
+        byValue.insert(pos, slot);
+        values.push_back(elem);
+        counts.push_back(1);
+        ids.push_back(slot);
+    }
+
+    /**
+     * @brief Remove all occurrences of an element.
+     * @param elem The element to remove.
+     * @throws std::runtime_error if the element is not found.
+     */
+    void removeElement(const T& elem) {
+        auto pos = lowerBound(elem);
+        if (pos == byValue.end() || !(values[*pos] == elem)) {
+            throw std::runtime_error("Element not found");
+        }
+        const std::uint32_t slot = *pos;
+        byValue.erase(pos);
+        values.erase(values.begin() + slot);
+        counts.erase(counts.begin() + slot);
+        ids.erase(std::remove(ids.begin(), ids.end(), slot), ids.end());
+        // Slots above the removed one shift down by one.
+        for (auto& s : ids) s -= (s > slot);
+        for (auto& s : byValue) s -= (s > slot);
+    }
+
+    /**
+     * @brief Get the number of elements in the container.
+     * @return Current size, counting duplicates.
+     */
+    std::size_t size() const { return ids.size(); }
+
+    /**
+     * @brief Number of distinct values stored.
+     */
+    std::size_t distinct_count() const { return values.size(); }
+
+    /**
+     * @brief Number of copies of x; O(log d).
+     */
+    std::size_t count(const T& x) const {
+        auto pos = lowerBound(x);
+        return (pos != byValue.end() && values[*pos] == x) ? counts[*pos] : 0;
+    }
+
+    /**
+     * @brief Stream output operator; prints elements in insertion order, e.g. "[ a b c ]".
+     */
+    friend std::ostream& operator<<(std::ostream& os, const MyCompressedContainer& cont) {
+        os << "[ ";
+        for (std::uint32_t s : cont.ids) os << cont.values[s] << " ";
+        return os << "]";
+    }
+
+    class Iterator;  ///< Walks any of the six orders over the compressed storage.
+
+    Iterator begin_ascending_order() const;
+    Iterator end_ascending_order() const { return end(); }
+    Iterator begin_descending_order() const;
+    Iterator end_descending_order() const { return end(); }
+    Iterator begin_side_cross_order() const;
+    Iterator end_side_cross_order() const { return end(); }
+    Iterator begin_reverse_order() const { return Iterator(this, Mode::Reverse, 0); }
+    Iterator end_reverse_order() const { return end(); }
+    Iterator begin_order() const { return Iterator(this, Mode::Insertion, 0); }
+    Iterator end_order() const { return end(); }
+    Iterator begin_middle_out_order() const { return Iterator(this, Mode::MiddleOut, 0); }
+    Iterator end_middle_out_order() const { return end(); }
+
+private:
+    // End iterators only compare by index, so they skip the run boundaries.
+    Iterator end() const { return Iterator(this, Mode::Insertion, size()); }
+    Iterator sortedBegin(Mode mode) const;
+};
+
+/**
+ * @class MyCompressedContainer::Iterator
+ * @brief Maps each position to an insertion index or an ascending rank.
+ *
+ * Sorted modes carry the cumulative run lengths in ascending value order
+ * (d + 1 entries, built in O(d) by begin_*), and find a rank's run by
+ * binary search.
+ */
+template<typename T>
+class MyCompressedContainer<T>::Iterator {
+    friend class MyCompressedContainer;
+
+    const MyCompressedContainer* cont;
+    Mode mode;
+    std::size_t index;
+    detail::IndexBuffer runEnd;  ///< runEnd[j]: elements in the first j+1 runs of byValue.
+
+    Iterator(const MyCompressedContainer* c, Mode m, std::size_t i)
+        : cont(c), mode(m), index(i) {}
+
+    // const_reference is a plain bool for T = bool (std::vector<bool> has no addressable elements).
+    typename std::vector<T>::const_reference valueAtRank(std::size_t r) const {
+        const std::size_t* run = std::upper_bound(runEnd.begin(), runEnd.end(), r);
+        return cont->values[cont->byValue[static_cast<std::size_t>(run - runEnd.begin())]];
+    }
+
+public:
+    Iterator& operator++() { ++index; return *this; }
+    bool operator==(const Iterator& o) const {
+        return cont==o.cont && index==o.index;
+    }
+    bool operator!=(const Iterator& o) const { return !(*this==o); }
+
+    T operator*() const {
+        const std::size_t n = cont->size();
+        if (index >= n) throw std::out_of_range("MyCompressedContainer::Iterator");
+        const std::size_t mid = n / 2;
+        switch (mode) {
+            case Mode::Ascending:  return valueAtRank(index);
+            case Mode::Descending: return valueAtRank(n - 1 - index);
+            case Mode::SideCross:  return valueAtRank((index % 2) ? n - 1 - index / 2 : index / 2);
+            case Mode::Reverse:    return cont->values[cont->ids[n - 1 - index]];
+            case Mode::Insertion:  return cont->values[cont->ids[index]];
+            case Mode::MiddleOut:
+                return cont->values[cont->ids[index == 0 ? mid
+                                              : (index % 2) ? mid - (index + 1) / 2 : mid + index / 2]];
+        }
+        throw std::logic_error("MyCompressedContainer::Iterator: bad mode");
+    }
+};
+
+template<typename T>
+auto MyCompressedContainer<T>::sortedBegin(Mode mode) const -> Iterator {
+    Iterator it(this, mode, 0);
+    it.runEnd.reserve(byValue.size());
+    std::size_t total = 0;
+    for (std::uint32_t s : byValue) it.runEnd.push_back(total += counts[s]);
+    return it;
+}
+
+template<typename T>
+auto MyCompressedContainer<T>::begin_ascending_order() const -> Iterator {
+    return sortedBegin(Mode::Ascending);
+}
+
+template<typename T>
+auto MyCompressedContainer<T>::begin_descending_order() const -> Iterator {
+    return sortedBegin(Mode::Descending);
+}
+
+template<typename T>
+auto MyCompressedContainer<T>::begin_side_cross_order() const -> Iterator {
+    return sortedBegin(Mode::SideCross);
+}
+
+} // namespace ariel
+
+#endif // MYCOMPRESSEDCONTAINER_HPP
@@ -2,6 +2,9 @@
 #include <algorithm>
 #include <numeric>
 #include <stdexcept>
+#include <functional>
+#include <iterator>
+#include <utility>
 
 /**
  * danieldaniel2468@gmail.com
@@ -9,47 +12,676 @@
 
 namespace ariel {
 
+// — Construction —
+// data allocates through the inline arena (if any), which falls back to resource.
+template<typename T, std::size_t InlineN>
+MyContainer<T, InlineN>::MyContainer(std::pmr::memory_resource* resource)
+    : ArenaBase(resource), data(ArenaBase::storageResource()), cache(ArenaBase::inlineCache()) {
+    if constexpr (InlineN > 0) data.reserve(InlineN);
+}
+
+template<typename T, std::size_t InlineN>
+MyContainer<T, InlineN>::MyContainer(const MyContainer& other) : MyContainer() {
+    assignFrom(other.data.begin(), other.data.end());
+    insertionSorted = other.insertionSorted;
+    copyCacheFrom(other);
+    if (other.sketches) emplaceSketches(*other.sketches, get_resource());
+}
+
+template<typename T, std::size_t InlineN>
+MyContainer<T, InlineN>::MyContainer(MyContainer&& other) noexcept(InlineN == 0)
+    : MyContainer(other.get_resource()) {
+    if constexpr (InlineN == 0) data = std::move(other.data);
+    else assignFrom(std::make_move_iterator(other.data.begin()), std::make_move_iterator(other.data.end()));
+    insertionSorted = other.insertionSorted;
+    takeCacheFrom(other);
+    sketches = std::exchange(other.sketches, nullptr);   // same resource: the block changes hands
+    other.data.clear();
+    other.insertionSorted = true;
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::operator=(const MyContainer& other) -> MyContainer& {
+    if (this != &other) {
+        assignFrom(other.data.begin(), other.data.end());
+        insertionSorted = other.insertionSorted;
+        copyCacheFrom(other);
+        if (other.sketches) emplaceSketches(*other.sketches, get_resource());
+        else dropSketches();
+    }
+    return *this;
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::operator=(MyContainer&& other) -> MyContainer& {
+    if (this != &other) {
+        if constexpr (InlineN == 0) data = std::move(other.data);
+        else assignFrom(std::make_move_iterator(other.data.begin()), std::make_move_iterator(other.data.end()));
+        insertionSorted = other.insertionSorted;
+        takeCacheFrom(other);
+        if (other.sketches && other.get_resource() == get_resource()) {
+            dropSketches();
+            sketches = std::exchange(other.sketches, nullptr);
+        } else if (other.sketches) {
+            emplaceSketches(*other.sketches, get_resource());
+            other.dropSketches();
+        } else {
+            dropSketches();
+        }
+        other.data.clear();
+        other.insertionSorted = true;
+    }
+    return *this;
+}
+
+template<typename T, std::size_t InlineN>
+MyContainer<T, InlineN>::~MyContainer() {
+    dropSketches();
+    releaseCache();
+}
+
+// The new sketches are built before the old ones go, so a throwing copy leaves
+// the container unchanged.
+template<typename T, std::size_t InlineN>
+template<typename... Args>
+void MyContainer<T, InlineN>::emplaceSketches(Args&&... args) {
+    std::pmr::polymorphic_allocator<Sketches> alloc(get_resource());
+    Sketches* fresh = alloc.allocate(1);
+    try {
+        alloc.construct(fresh, std::forward<Args>(args)...);
+    } catch (...) {
+        alloc.deallocate(fresh, 1);
+        throw;
+    }
+    dropSketches();
+    sketches = fresh;
+}
+
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::dropSketches() noexcept {
+    if (!sketches) return;
+    std::pmr::polymorphic_allocator<Sketches> alloc(get_resource());
+    alloc.destroy(sketches);
+    alloc.deallocate(sketches, 1);
+    sketches = nullptr;
+}
+
+// — Order cache —
+// Concurrent const callers may race to allocate the cache; the loser frees its copy.
+template<typename T, std::size_t InlineN>
+detail::OrderCache& MyContainer<T, InlineN>::orderCache() const {
+    detail::OrderCache* current = cache.load(std::memory_order_acquire);
+    if (current) return *current;
+    std::pmr::polymorphic_allocator<detail::OrderCache> alloc(get_resource());
+    detail::OrderCache* fresh = alloc.allocate(1);
+    alloc.construct(fresh, get_resource());   // noexcept
+    if (cache.compare_exchange_strong(current, fresh, std::memory_order_acq_rel)) return *fresh;
+    alloc.destroy(fresh);
+    alloc.deallocate(fresh, 1);
+    return *current;
+}
+
+template<typename T, std::size_t InlineN>
+detail::OrderCache* MyContainer<T, InlineN>::validCache() const noexcept {
+    detail::OrderCache* c = cache.load(std::memory_order_acquire);
+    return c && c->valid.load(std::memory_order_acquire) ? c : nullptr;
+}
+
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::invalidateCache() noexcept {
+    if (detail::OrderCache* c = cache.load(std::memory_order_relaxed)) c->valid = false;
+}
+
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::releaseCache() noexcept {
+    detail::OrderCache* c = cache.exchange(nullptr);
+    if (!c || c == ArenaBase::inlineCache()) return;
+    std::pmr::polymorphic_allocator<detail::OrderCache> alloc(get_resource());
+    alloc.destroy(c);
+    alloc.deallocate(c, 1);
+}
+
+// An allocated cache on the same resource changes hands (never throws, which the
+// move constructor relies on); otherwise a valid order is moved or copied into ours.
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::takeCacheFrom(MyContainer& other) {
+    if constexpr (InlineN == 0) {
+        if (other.get_resource() == get_resource()) {
+            releaseCache();
+            cache.store(other.cache.exchange(nullptr));
+            return;
+        }
+    }
+    invalidateCache();
+    if (detail::OrderCache* theirs = other.validCache()) {
+        detail::OrderCache& mine = orderCache();
+        if (mine.index.resource() == theirs->index.resource()) mine.index = std::move(theirs->index);
+        else mine.index = theirs->index;   // copied: it must stay on this container's resource
+        mine.valid = true;
+        theirs->valid = false;
+    }
+}
+
+// Only a valid cache is copied: until then a const call on other may be filling it.
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::copyCacheFrom(const MyContainer& other) {
+    invalidateCache();
+    if (const detail::OrderCache* theirs = other.validCache()) {
+        detail::OrderCache& mine = orderCache();
+        mine.index = theirs->index;
+        mine.valid = true;
+    }
+}
+
+template<typename T, std::size_t InlineN>
+template<typename It>
+void MyContainer<T, InlineN>::assignFrom(It first, It last) {
+    data.clear();
+    data.reserve(std::max<std::size_t>(InlineN, static_cast<std::size_t>(std::distance(first, last))));
+    data.insert(data.end(), first, last);
+}
+
 // — Core operations —
 // Adds an element at the end.
-template<typename T>
-void MyContainer<T>::addElement(const T& elem) {
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::addElement(const T& elem) {
+    if (!data.empty() && elem < data.back()) insertionSorted = false;
+    if (detail::OrderCache* c = validCache()) {
+        // A new maximum (or tie) extends the cached order; anything else invalidates it.
+        if (c->index.empty() || !(elem < data[c->index.back()])) c->index.push_back(data.size());
+        else c->valid = false;
+    }
     data.push_back(elem);
+    if (sketches) sketches->add(elem);
 }
 
 // Removes all occurrences of elem, throws if not found.
-template<typename T>
-void MyContainer<T>::removeElement(const T& elem) {
-    if (std::count(data.begin(), data.end(), elem) == 0) {
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::removeElement(const T& elem) {
+    auto copies = std::count(data.begin(), data.end(), elem);
+    if (copies == 0) {
         throw std::runtime_error("Element not found");
     }
+    if (sketches) {
+        for (; copies > 0; --copies) sketches->remove(elem);
+    }
     data.erase(std::remove(data.begin(), data.end(), elem), data.end());
+    if (data.empty()) insertionSorted = true;
+    invalidateCache();
+    refreshSketch();
+}
+
+// Removes all elements whose projection equals key, throws if none match.
+template<typename T, std::size_t InlineN>
+template<typename Key, typename Projection>
+void MyContainer<T, InlineN>::removeElement(const Key& key, Projection proj) {
+    auto matches = [&](const T& e) { return std::invoke(proj, e) == key; };
+    if (sketches) {
+        for (const T& e : data) {
+            if (matches(e)) sketches->remove(e);
+        }
+    }
+    auto it = std::remove_if(data.begin(), data.end(), matches);
+    if (it == data.end()) {
+        throw std::runtime_error("Element not found");
+    }
+    data.erase(it, data.end());
+    if (data.empty()) insertionSorted = true;
+    invalidateCache();
+    refreshSketch();
+}
+
+// Merges the two ascending orders (other's indices shifted by size()), then
+// moves the elements over.
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::merge(MyContainer&& other) {
+    if (&other == this) throw std::invalid_argument("merge: cannot merge a container into itself");
+    const std::size_t n = data.size();
+    const detail::IndexBuffer& mine = ascendingIndex();
+    const detail::IndexBuffer& theirs = other.ascendingIndex();
+
+    detail::IndexBuffer merged(get_resource());
+    merged.reserve(n + other.data.size());
+    const std::size_t* i = mine.begin();
+    const std::size_t* j = theirs.begin();
+    while (i != mine.end() && j != theirs.end()) {
+        if (other.data[*j] < data[*i]) merged.push_back(n + *j++);
+        else merged.push_back(*i++);
+    }
+    for (; i != mine.end(); ++i) merged.push_back(*i);
+    for (; j != theirs.end(); ++j) merged.push_back(n + *j);
+
+    if (sketches) {
+        if (other.sketches && other.sketches->added.k() == sketches->added.k()) {
+            sketches->added.merge(other.sketches->added);
+            sketches->removed.merge(other.sketches->removed);
+            sketches->cdfValid = false;
+        } else {
+            for (const T& e : other.data) sketches->add(e);
+        }
+    }
+    insertionSorted = insertionSorted && other.insertionSorted &&
+                      (n == 0 || other.data.empty() || !(other.data.front() < data.back()));
+    data.insert(data.end(), std::make_move_iterator(other.data.begin()),
+                std::make_move_iterator(other.data.end()));
+    detail::OrderCache& mineCache = orderCache();
+    mineCache.index.swap(merged);
+    mineCache.valid = true;
+
+    other.data.clear();
+    other.insertionSorted = true;
+    other.invalidateCache();
+    other.dropSketches();
+    refreshSketch();
+}
+
+// Assigns every element its part, then moves elements in insertion order while
+// recording their new positions, which translate the cached order per part.
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::split_by_pivots(const std::vector<T>& pivots) -> std::vector<MyContainer> {
+    if (!std::is_sorted(pivots.begin(), pivots.end())) {
+        throw std::invalid_argument("split_by_pivots: pivots must be sorted");
+    }
+    const std::size_t n = data.size();
+    detail::IndexBuffer part(n, get_resource());
+    const detail::OrderCache* sorted = validCache();
+    if (sorted) {
+        std::size_t p = 0;   // parts are contiguous slices of the ascending order
+        for (std::size_t i : sorted->index) {
+            while (p < pivots.size() && !(data[i] < pivots[p])) ++p;
+            part[i] = p;
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            part[i] = static_cast<std::size_t>(
+                std::upper_bound(pivots.begin(), pivots.end(), data[i]) - pivots.begin());
+        }
+    }
+
+    std::vector<MyContainer> parts;
+    parts.reserve(pivots.size() + 1);   // no reallocation: moves would not be noexcept
+    for (std::size_t p = 0; p <= pivots.size(); ++p) parts.emplace_back(get_resource());
+    detail::IndexBuffer newPos(n, get_resource());
+    for (std::size_t i = 0; i < n; ++i) {
+        MyContainer& dst = parts[part[i]];
+        if (!dst.data.empty() && data[i] < dst.data.back()) dst.insertionSorted = false;
+        newPos[i] = dst.data.size();
+        dst.data.push_back(std::move(data[i]));
+    }
+    if (sorted) {
+        for (std::size_t i : sorted->index) parts[part[i]].orderCache().index.push_back(newPos[i]);
+        for (MyContainer& dst : parts) dst.orderCache().valid = true;
+    }
+    if (sketches) {
+        for (MyContainer& dst : parts) dst.enable_sketch(sketches->added.k());
+    }
+
+    data.clear();
+    insertionSorted = true;
+    invalidateCache();
+    dropSketches();
+    return parts;
 }
 
 // Returns number of stored elements.
-template<typename T>
-std::size_t MyContainer<T>::size() const {
+template<typename T, std::size_t InlineN>
+std::size_t MyContainer<T, InlineN>::size() const {
     return data.size();
 }
 
+// Resource shared by data and every permutation buffer.
+template<typename T, std::size_t InlineN>
+std::pmr::memory_resource* MyContainer<T, InlineN>::get_resource() const {
+    return ArenaBase::upstreamResource();
+}
+
+// Sorts a copy of the values themselves; iteration then reads one contiguous array.
+template<typename T, std::size_t InlineN>
+std::vector<T> MyContainer<T, InlineN>::sorted_values() const {
+    std::vector<T> values(data.begin(), data.end());
+    if (!insertionSorted) std::sort(values.begin(), values.end());
+    return values;
+}
+
+// Sorted insertion under the natural order needs no sorting at all. Concurrent
+// const callers race to fill the cache, so the fill is double-checked under
+// the cache's lock; once it is valid the index is only read until the next
+// (non-const) modification.
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::ascendingIndex() const -> const detail::IndexBuffer& {
+    detail::OrderCache& c = orderCache();
+    if (c.valid.load(std::memory_order_acquire)) return c.index;
+    std::lock_guard<std::mutex> lock(c.fill);
+    if (!c.valid.load(std::memory_order_relaxed)) {
+        if (insertionSorted) {
+            c.index.resize(data.size());
+            std::iota(c.index.begin(), c.index.end(), 0);
+        } else {
+            std::less<> comp;
+            identity proj;
+            detail::sortIndices(data, c.index, comp, proj);
+        }
+        c.valid.store(true, std::memory_order_release);
+    }
+    return c.index;
+}
+
+// The natural order is served from the cache; custom orders are sorted afresh.
+template<typename T, std::size_t InlineN>
+template<typename Compare, typename Projection>
+void MyContainer<T, InlineN>::buildAscending(detail::IndexBuffer& order,
+                                    Compare& comp, Projection& proj) const {
+    if constexpr (detail::is_natural_order<T, Compare, Projection>) {
+        order = ascendingIndex();
+    } else {
+        detail::sortIndices(data, order, comp, proj);
+    }
+}
+
+// — Order statistics —
+// Cached order: direct lookup. Otherwise a selection over a scratch index buffer.
+template<typename T, std::size_t InlineN>
+T MyContainer<T, InlineN>::nth_smallest(std::size_t k) const {
+    if (k >= data.size()) throw std::out_of_range("nth_smallest: rank out of range");
+    if (const detail::OrderCache* c = validCache()) return data[c->index[k]];
+    if (insertionSorted) return data[k];
+    detail::IndexBuffer idx(data.size(), get_resource());
+    std::iota(idx.begin(), idx.end(), 0);
+    std::nth_element(idx.begin(), idx.begin() + k, idx.end(),
+                     [&](std::size_t a, std::size_t b) { return data[a] < data[b]; });
+    return data[idx[k]];
+}
+
+template<typename T, std::size_t InlineN>
+std::size_t MyContainer<T, InlineN>::rank(const T& x) const {
+    if (const detail::OrderCache* c = validCache()) {
+        auto it = std::lower_bound(c->index.begin(), c->index.end(), x,
+                                   [&](std::size_t i, const T& v) { return data[i] < v; });
+        return static_cast<std::size_t>(it - c->index.begin());
+    }
+    if (insertionSorted) {
+        return static_cast<std::size_t>(std::lower_bound(data.begin(), data.end(), x) - data.begin());
+    }
+    return static_cast<std::size_t>(std::count_if(data.begin(), data.end(),
+                                                  [&](const T& e) { return e < x; }));
+}
+
+template<typename T, std::size_t InlineN>
+T MyContainer<T, InlineN>::median() const {
+    if (data.empty()) throw std::out_of_range("median of empty container");
+    return nth_smallest((data.size() - 1) / 2);
+}
+
+template<typename T, std::size_t InlineN>
+std::vector<T> MyContainer<T, InlineN>::valuesAtRanks(const std::vector<std::size_t>& ranks) const {
+    std::vector<T> out;
+    out.reserve(ranks.size());
+    const detail::OrderCache* c = validCache();
+    if (c || insertionSorted) {
+        for (std::size_t r : ranks) out.push_back(c ? data[c->index[r]] : data[r]);
+        return out;
+    }
+    detail::IndexBuffer wanted(get_resource());
+    for (std::size_t r : ranks) wanted.push_back(r);
+    std::sort(wanted.begin(), wanted.end());
+    const std::size_t* wantedEnd = std::unique(wanted.begin(), wanted.end());
+
+    detail::IndexBuffer idx(data.size(), get_resource());
+    std::iota(idx.begin(), idx.end(), 0);
+    auto less = [&](std::size_t a, std::size_t b) { return data[a] < data[b]; };
+    detail::multiSelect(idx.begin(), idx.end(), 0, wanted.begin(), wantedEnd, less);
+    for (std::size_t r : ranks) out.push_back(data[idx[r]]);
+    return out;
+}
+
+template<typename T, std::size_t InlineN>
+std::vector<T> MyContainer<T, InlineN>::quantiles(const std::vector<double>& qs) const {
+    if (qs.empty()) return {};
+    if (data.empty()) throw std::out_of_range("quantiles of empty container");
+    std::vector<std::size_t> ranks;
+    ranks.reserve(qs.size());
+    for (double q : qs) {
+        if (!(q >= 0.0 && q <= 1.0)) throw std::out_of_range("quantile outside [0, 1]");
+        ranks.push_back(static_cast<std::size_t>(q * static_cast<double>(data.size() - 1)));
+    }
+    return valuesAtRanks(ranks);
+}
+
+template<typename T, std::size_t InlineN>
+std::vector<T> MyContainer<T, InlineN>::sample_every(std::size_t stride) const {
+    if (stride == 0) throw std::invalid_argument("sample_every: stride must be positive");
+    std::vector<std::size_t> ranks;
+    ranks.reserve(data.empty() ? 0 : (data.size() - 1) / stride + 1);
+    for (std::size_t r = 0; r < data.size(); r += stride) {
+        ranks.push_back(r);
+        if (stride >= data.size() - r) break;   // avoid overflowing r
+    }
+    return valuesAtRanks(ranks);
+}
+
+// — Approximate quantiles —
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::enable_sketch(std::size_t k) {
+    emplaceSketches(k, get_resource());
+    for (const T& e : data) sketches->add(e);
+}
+
+// The approximate answers difference two sketches, so their rank error is about
+// eps * (added + removed) / size(). Rebuilding from the elements once removals
+// pass size() / 4 keeps it within 1.5 * eps; each rebuild follows at least
+// size() / 4 removals, so it costs O(1) amortised sketch updates per removal.
+template<typename T, std::size_t InlineN>
+void MyContainer<T, InlineN>::refreshSketch() {
+    if (sketches && sketches->removed.count() * 4 > data.size()) enable_sketch(sketches->added.k());
+}
+
+template<typename T, std::size_t InlineN>
+bool MyContainer<T, InlineN>::has_sketch() const noexcept {
+    return sketches != nullptr;
+}
+
+template<typename T, std::size_t InlineN>
+double MyContainer<T, InlineN>::approx_rank(const T& x) const {
+    if (!sketches) throw std::logic_error("approx_rank: sketch not enabled");
+    return std::max(0.0, sketches->added.rank(x) - sketches->removed.rank(x));
+}
+
+// The table walks the added items (+weight) and removed items (-weight) in
+// order, removals first on ties so a fully removed value is never returned, and
+// records for each added item the running maximum of the net count, which keeps
+// the table sorted for binary search.
+template<typename T, std::size_t InlineN>
+T MyContainer<T, InlineN>::approx_quantile(double q) const {
+    if (!sketches) throw std::logic_error("approx_quantile: sketch not enabled");
+    if (data.empty()) throw std::out_of_range("approx_quantile of empty container");
+    if (!(q >= 0.0 && q <= 1.0)) throw std::out_of_range("quantile outside [0, 1]");
+
+    std::lock_guard<std::mutex> lock(sketches->cdfMutex);
+    auto& cdf = sketches->cdf;
+    if (!sketches->cdfValid) {
+        struct Item { T value; double weight; };
+        std::pmr::vector<Item> items(get_resource());
+        for (const auto& [v, w] : sketches->removed.weightedItems()) items.push_back({v, -static_cast<double>(w)});
+        for (const auto& [v, w] : sketches->added.weightedItems()) items.push_back({v, static_cast<double>(w)});
+        std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+            return a.value < b.value || (!(b.value < a.value) && a.weight < b.weight);
+        });
+        cdf.clear();
+        double seen = 0, best = 0;
+        for (const Item& it : items) {
+            seen += it.weight;
+            if (it.weight > 0) cdf.emplace_back(it.value, best = std::max(best, seen));
+        }
+        sketches->cdfValid = true;
+    }
+    const double target = q * static_cast<double>(data.size());
+    auto it = std::upper_bound(cdf.begin(), cdf.end(), target,
+                               [](double t, const std::pair<T, double>& e) { return t < e.second; });
+    return it == cdf.end() ? cdf.back().first : it->first;
+}
+
+// — Position mapping —
+// Position k maps to mid, mid-1, mid+1, mid-2, ... without storing an order.
+// The left side is never shorter than the right, so the sides simply alternate.
+template<typename T, std::size_t InlineN>
+std::size_t MyContainer<T, InlineN>::middleOutIndex(std::size_t n, std::size_t k) {
+    const std::size_t mid = n / 2;
+    if (k == 0) return mid;
+    return (k % 2) ? mid - (k + 1) / 2 : mid + k / 2;
+}
+
+template<typename T, std::size_t InlineN>
+std::size_t MyContainer<T, InlineN>::positionSource(Traversal order, std::size_t n, std::size_t k) {
+    switch (order) {
+        case Traversal::Ascending:  return k;
+        case Traversal::Descending: return n - 1 - k;
+        case Traversal::SideCross:  return (k % 2) ? n - 1 - k / 2 : k / 2;
+        case Traversal::Reverse:    return n - 1 - k;
+        case Traversal::Insertion:  return k;
+        case Traversal::MiddleOut:  return middleOutIndex(n, k);
+    }
+    return k;
+}
+
+// — Pagination —
+// Sorted traversals map page positions to ascending ranks. The ranks on a page
+// form at most two contiguous intervals (side-cross takes from both ends), so
+// without a cached order each interval is isolated by nth_element and sorted.
+template<typename T, std::size_t InlineN>
+std::vector<T> MyContainer<T, InlineN>::page(Traversal order, std::size_t page,
+                                             std::size_t pageSize) const {
+    const std::size_t n = data.size();
+    std::vector<T> out;
+    if (pageSize == 0 || page >= n / pageSize + (n % pageSize != 0)) return out;
+    const std::size_t first = page * pageSize;   // < n, so no overflow
+    const std::size_t last = pageSize >= n - first ? n : first + pageSize;
+    out.reserve(last - first);
+
+    const bool sorted = order == Traversal::Ascending || order == Traversal::Descending ||
+                        order == Traversal::SideCross;
+    const detail::OrderCache* c = validCache();
+    if (!sorted || insertionSorted || c) {
+        for (std::size_t k = first; k < last; ++k) {
+            const std::size_t src = positionSource(order, n, k);
+            out.push_back(sorted && c ? data[c->index[src]] : data[src]);
+        }
+        return out;
+    }
+
+    // Rank intervals [lo, hi) touched by the page, smallest first.
+    std::pair<std::size_t, std::size_t> spans[2];
+    std::size_t spanCount = 0;
+    if (order == Traversal::SideCross) {
+        const std::size_t firstEven = first + (first % 2), firstOdd = first + 1 - (first % 2);
+        if (firstEven < last) spans[spanCount++] = {firstEven / 2, (last - 1) / 2 + 1};
+        if (firstOdd < last) spans[spanCount++] = {n - 1 - (last % 2 ? last - 1 : last - 2) / 2, n - firstOdd / 2};
+    } else {
+        const std::size_t a = positionSource(order, n, first), b = positionSource(order, n, last - 1);
+        spans[spanCount++] = {std::min(a, b), std::max(a, b) + 1};
+    }
+
+    detail::IndexBuffer idx(n, get_resource());
+    std::iota(idx.begin(), idx.end(), 0);
+    auto less = [&](std::size_t a, std::size_t b) { return data[a] < data[b]; };
+    std::size_t done = 0;   // idx[0, done) already holds the smallest `done` ranks
+    for (std::size_t s = 0; s < spanCount; ++s) {
+        const auto [lo, hi] = spans[s];
+        if (lo > done) std::nth_element(idx.begin() + done, idx.begin() + lo, idx.end(), less);
+        if (hi < n) std::nth_element(idx.begin() + lo, idx.begin() + hi, idx.end(), less);
+        std::sort(idx.begin() + lo, idx.begin() + hi, less);
+        done = hi;
+    }
+    for (std::size_t k = first; k < last; ++k) out.push_back(data[idx[positionSource(order, n, k)]]);
+    return out;
+}
+
+// — Top-k / bottom-k —
+// Small k streams through a bounded heap whose top is the worst kept element;
+// larger k partitions with nth_element and sorts only the first k.
+template<typename T, std::size_t InlineN>
+template<typename Before>
+void MyContainer<T, InlineN>::selectFirst(std::size_t k, Before before,
+                                          detail::IndexBuffer& idx) const {
+    const std::size_t n = data.size();
+    if (k == 0) {
+        idx.clear();
+    } else if (k * 16 <= n) {
+        idx.clear();
+        idx.reserve(k);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (idx.size() < k) {
+                idx.push_back(i);
+                std::push_heap(idx.begin(), idx.end(), before);
+            } else if (before(i, idx[0])) {
+                std::pop_heap(idx.begin(), idx.end(), before);
+                idx[k - 1] = i;
+                std::push_heap(idx.begin(), idx.end(), before);
+            }
+        }
+        std::sort_heap(idx.begin(), idx.end(), before);
+    } else {
+        idx.resize(n);
+        std::iota(idx.begin(), idx.end(), 0);
+        std::nth_element(idx.begin(), idx.begin() + k, idx.end(), before);
+        std::sort(idx.begin(), idx.begin() + k, before);
+        idx.resize(k);
+    }
+}
+
+template<typename T, std::size_t InlineN>
+template<typename OutputIt>
+OutputIt MyContainer<T, InlineN>::bottom_k(std::size_t k, OutputIt out) const {
+    const std::size_t n = data.size();
+    k = std::min(k, n);
+    const detail::OrderCache* c = validCache();
+    if (c || insertionSorted) {
+        for (std::size_t r = 0; r < k; ++r) *out++ = c ? data[c->index[r]] : data[r];
+        return out;
+    }
+    detail::IndexBuffer idx(get_resource());
+    selectFirst(k, [&](std::size_t a, std::size_t b) { return data[a] < data[b]; }, idx);
+    for (std::size_t i : idx) *out++ = data[i];
+    return out;
+}
+
+template<typename T, std::size_t InlineN>
+template<typename OutputIt>
+OutputIt MyContainer<T, InlineN>::top_k(std::size_t k, OutputIt out) const {
+    const std::size_t n = data.size();
+    k = std::min(k, n);
+    const detail::OrderCache* c = validCache();
+    if (c || insertionSorted) {
+        for (std::size_t r = n; r > n - k; --r) *out++ = c ? data[c->index[r - 1]] : data[r - 1];
+        return out;
+    }
+    detail::IndexBuffer idx(get_resource());
+    selectFirst(k, [&](std::size_t a, std::size_t b) { return data[b] < data[a]; }, idx);
+    for (std::size_t i : idx) *out++ = data[i];
+    return out;
+}
+
 // — AscendingIterator —
 // Iterates elements in increasing order.
-template<typename T>
-class MyContainer<T>::AscendingIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::AscendingIterator {
     const MyContainer* cont;
-    std::vector<std::size_t> order;
+    detail::IndexBuffer order;
     std::size_t index;
 
     // Build sorted index map.
-    void initOrder() {
-        order.resize(cont->data.size());
-        std::iota(order.begin(), order.end(), 0);
-        std::sort(order.begin(), order.end(),
-                  [&](auto a, auto b){ return cont->data[a] < cont->data[b]; });
+    template<typename Compare, typename Projection>
+    void initOrder(Compare& comp, Projection& proj) {
+        cont->buildAscending(order, comp, proj);
     }
 
 public:
-    AscendingIterator(const MyContainer* c, std::size_t i)
-        : cont(c), index(i) { initOrder(); }
+    // End iterators only compare by index, so they skip building the order.
+    template<typename Compare = std::less<>, typename Projection = identity>
+    AscendingIterator(const MyContainer* c, std::size_t i,
+                      Compare comp = {}, Projection proj = {})
+        : cont(c), order(c->get_resource()), index(i) {
+        if (index < cont->data.size()) initOrder(comp, proj);
+    }
 
     AscendingIterator& operator++() { ++index; return *this; }
     bool operator==(const AscendingIterator& o) const {
@@ -59,33 +691,42 @@ public:
     T operator*() const { return cont->data.at(order.at(index)); }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_ascending_order() const -> AscendingIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_ascending_order() const -> AscendingIterator {
     return AscendingIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_ascending_order() const -> AscendingIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_ascending_order() const -> AscendingIterator {
     return AscendingIterator(this, data.size());
 }
+template<typename T, std::size_t InlineN>
+template<typename Compare, typename Projection>
+auto MyContainer<T, InlineN>::begin_ascending_order(Compare comp, Projection proj) const -> AscendingIterator {
+    return AscendingIterator(this, 0, comp, proj);
+}
 
 // — DescendingIterator —
 // Iterates elements in decreasing order.
-template<typename T>
-class MyContainer<T>::DescendingIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::DescendingIterator {
     const MyContainer* cont;
-    std::vector<std::size_t> order;
+    detail::IndexBuffer order;
     std::size_t index;
 
-    void initOrder() {
-        order.resize(cont->data.size());
-        std::iota(order.begin(), order.end(), 0);
-        std::sort(order.begin(), order.end(),
-                  [&](auto a, auto b){ return cont->data[a] > cont->data[b]; });
+    // Descending is the ascending permutation walked backwards.
+    template<typename Compare, typename Projection>
+    void initOrder(Compare& comp, Projection& proj) {
+        cont->buildAscending(order, comp, proj);
+        std::reverse(order.begin(), order.end());
     }
 
 public:
-    DescendingIterator(const MyContainer* c, std::size_t i)
-        : cont(c), index(i) { initOrder(); }
+    template<typename Compare = std::less<>, typename Projection = identity>
+    DescendingIterator(const MyContainer* c, std::size_t i,
+                       Compare comp = {}, Projection proj = {})
+        : cont(c), order(c->get_resource()), index(i) {
+        if (index < cont->data.size()) initOrder(comp, proj);
+    }
 
     DescendingIterator& operator++() { ++index; return *this; }
     bool operator==(const DescendingIterator& o) const {
@@ -95,33 +736,37 @@ public:
     T operator*() const { return cont->data.at(order.at(index)); }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_descending_order() const -> DescendingIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_descending_order() const -> DescendingIterator {
     return DescendingIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_descending_order() const -> DescendingIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_descending_order() const -> DescendingIterator {
     return DescendingIterator(this, data.size());
 }
+template<typename T, std::size_t InlineN>
+template<typename Compare, typename Projection>
+auto MyContainer<T, InlineN>::begin_descending_order(Compare comp, Projection proj) const -> DescendingIterator {
+    return DescendingIterator(this, 0, comp, proj);
+}
 
 // — SideCrossIterator —
 // Alternates smallest, largest, next-smallest, next-largest...
-template<typename T>
-class MyContainer<T>::SideCrossIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::SideCrossIterator {
     const MyContainer* cont;
-    std::vector<std::size_t> order;
+    detail::IndexBuffer order;
     std::size_t index;
 
-    void initOrder() {
+    template<typename Compare, typename Projection>
+    void initOrder(Compare& comp, Projection& proj) {
         const auto n = cont->data.size();
         if (n <= 1) {          // empty or single element
-            if (n == 1) order = {0};
+            if (n == 1) order.push_back(0);
             return;
         }
-        std::vector<std::size_t> sorted(n);
-        std::iota(sorted.begin(), sorted.end(), 0);
-        std::sort(sorted.begin(), sorted.end(),
-                  [&](auto a, auto b){ return cont->data[a] < cont->data[b]; });
+        detail::IndexBuffer sorted(cont->get_resource());
+        cont->buildAscending(sorted, comp, proj);
         std::size_t l = 0, r = n-1;
         while (l <= r) {
             order.push_back(sorted[l]);
@@ -131,10 +776,13 @@ class MyContainer<T>::SideCrossIterator {
     }
 
 public:
-    SideCrossIterator(const MyContainer* c, std::size_t i)
-        : cont(c), index(i) {
+    template<typename Compare = std::less<>, typename Projection = identity>
+    SideCrossIterator(const MyContainer* c, std::size_t i,
+                      Compare comp = {}, Projection proj = {})
+        : cont(c), order(c->get_resource()), index(i) {
+        if (index >= cont->data.size()) return;
         order.reserve(cont->data.size());
-        initOrder();
+        initOrder(comp, proj);
     }
 
     SideCrossIterator& operator++() { ++index; return *this; }
@@ -145,19 +793,24 @@ public:
     T operator*() const { return cont->data.at(order.at(index)); }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_side_cross_order() const -> SideCrossIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_side_cross_order() const -> SideCrossIterator {
     return SideCrossIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_side_cross_order() const -> SideCrossIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_side_cross_order() const -> SideCrossIterator {
     return SideCrossIterator(this, data.size());
 }
+template<typename T, std::size_t InlineN>
+template<typename Compare, typename Projection>
+auto MyContainer<T, InlineN>::begin_side_cross_order(Compare comp, Projection proj) const -> SideCrossIterator {
+    return SideCrossIterator(this, 0, comp, proj);
+}
 
 // — ReverseIterator —
 // Iterates in reverse insertion order.
-template<typename T>
-class MyContainer<T>::ReverseIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::ReverseIterator {
     const MyContainer* cont;
     std::size_t index;
 
@@ -175,19 +828,19 @@ public:
     }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_reverse_order() const -> ReverseIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_reverse_order() const -> ReverseIterator {
     return ReverseIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_reverse_order() const -> ReverseIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_reverse_order() const -> ReverseIterator {
     return ReverseIterator(this, data.size());
 }
 
 // — OrderIterator —
 // Standard insertion-order traversal.
-template<typename T>
-class MyContainer<T>::OrderIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::OrderIterator {
     const MyContainer* cont;
     std::size_t index;
 
@@ -203,62 +856,376 @@ public:
     T operator*() const { return cont->data.at(index); }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_order() const -> OrderIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_order() const -> OrderIterator {
     return OrderIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_order() const -> OrderIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_order() const -> OrderIterator {
     return OrderIterator(this, data.size());
 }
 
 // — MiddleOutIterator —
 // Starts at the middle element, then alternates left and right.
-template<typename T>
-class MyContainer<T>::MiddleOutIterator {
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::MiddleOutIterator {
     const MyContainer* cont;
-    std::vector<std::size_t> order;
     std::size_t index;
 
-    void initOrder() {
-        const auto n = cont->data.size();
-        if (n <= 1) {
-            if (n == 1) order = {0};
-            return;
-        }
-        int mid = int(n / 2);
-        order.reserve(n);
-        order.push_back(mid);
-        int l = mid-1, r = mid+1;
-        while (order.size() < n) {
-            if (l >= 0) order.push_back(size_t(l));
-            if (order.size() == n) break;
-            if (r < int(n)) order.push_back(size_t(r));
-            --l; ++r;
-        }
-    }
-
 public:
     MiddleOutIterator(const MyContainer* c, std::size_t i)
-        : cont(c), index(i) {
-        initOrder();
-    }
+        : cont(c), index(i) {}
 
     MiddleOutIterator& operator++() { ++index; return *this; }
     bool operator==(const MiddleOutIterator& o) const {
         return cont==o.cont && index==o.index;
     }
     bool operator!=(const MiddleOutIterator& o) const { return !(*this==o); }
-    T operator*() const { return cont->data.at(order.at(index)); }
+    T operator*() const {
+        if (index >= cont->data.size()) throw std::out_of_range("MiddleOutIterator");
+        return cont->data[middleOutIndex(cont->data.size(), index)];
+    }
 };
 
-template<typename T>
-auto MyContainer<T>::begin_middle_out_order() const -> MiddleOutIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::begin_middle_out_order() const -> MiddleOutIterator {
     return MiddleOutIterator(this, 0);
 }
-template<typename T>
-auto MyContainer<T>::end_middle_out_order() const -> MiddleOutIterator {
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::end_middle_out_order() const -> MiddleOutIterator {
     return MiddleOutIterator(this, data.size());
 }
 
+// — RangeView —
+// Walks [first, last) of the cached ascending order, or the same slice backwards.
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::RangeView {
+    const MyContainer* cont;
+    const std::size_t* first;
+    const std::size_t* last;
+    bool reversed;
+
+public:
+    class iterator {
+        const MyContainer* cont;
+        const std::size_t* pos;
+        bool reversed;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        iterator(const MyContainer* c, const std::size_t* p, bool r)
+            : cont(c), pos(p), reversed(r) {}
+
+        iterator& operator++() { reversed ? --pos : ++pos; return *this; }
+        bool operator==(const iterator& o) const { return pos==o.pos; }
+        bool operator!=(const iterator& o) const { return !(*this==o); }
+        T operator*() const { return cont->data[reversed ? pos[-1] : *pos]; }
+    };
+
+    RangeView(const MyContainer* c, const std::size_t* f, const std::size_t* l, bool r)
+        : cont(c), first(f), last(l), reversed(r) {}
+
+    iterator begin() const { return iterator(cont, reversed ? last : first, reversed); }
+    iterator end() const { return iterator(cont, reversed ? first : last, reversed); }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+};
+
+// Binary-searches the cached order for the slice holding lo <= x <= hi.
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::valueBounds(const T& lo, const T& hi) const
+    -> std::pair<const std::size_t*, const std::size_t*> {
+    const detail::IndexBuffer& idx = ascendingIndex();
+    auto below = [&](std::size_t i, const T& v) { return data[i] < v; };
+    auto above = [&](const T& v, std::size_t i) { return v < data[i]; };
+    const std::size_t* first = std::lower_bound(idx.begin(), idx.end(), lo, below);
+    const std::size_t* last = std::upper_bound(first, idx.end(), hi, above);
+    return {first, std::max(first, last)};
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::ascending_range(const T& lo, const T& hi) const -> RangeView {
+    const auto bounds = valueBounds(lo, hi);
+    return RangeView(this, bounds.first, bounds.second, false);
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::descending_range(const T& lo, const T& hi) const -> RangeView {
+    const auto bounds = valueBounds(lo, hi);
+    return RangeView(this, bounds.first, bounds.second, true);
+}
+
+// — GroupView —
+// Each step scans forward over elements equal to the run's first one; the cached
+// order is ascending, so "equal" reduces to !(value < next).
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::GroupView {
+    const MyContainer* cont;
+    const std::size_t* first;
+    const std::size_t* last;
+
+public:
+    class iterator {
+        const MyContainer* cont;
+        const std::size_t* pos;
+        const std::size_t* runEnd;
+        const std::size_t* last;
+
+        const std::size_t* findRunEnd() const {
+            if (pos == last) return last;
+            const T& value = cont->data[*pos];
+            const std::size_t* e = pos + 1;
+            while (e != last && !(value < cont->data[*e])) ++e;
+            return e;
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Group;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Group;
+
+        iterator(const MyContainer* c, const std::size_t* p, const std::size_t* l)
+            : cont(c), pos(p), runEnd(p), last(l) { runEnd = findRunEnd(); }
+
+        iterator& operator++() { pos = runEnd; runEnd = findRunEnd(); return *this; }
+        bool operator==(const iterator& o) const { return pos==o.pos; }
+        bool operator!=(const iterator& o) const { return !(*this==o); }
+        Group operator*() const {
+            return Group{cont->data[*pos], static_cast<std::size_t>(runEnd - pos), pos, runEnd};
+        }
+    };
+
+    GroupView(const MyContainer* c, const std::size_t* f, const std::size_t* l)
+        : cont(c), first(f), last(l) {}
+
+    iterator begin() const { return iterator(cont, first, last); }
+    iterator end() const { return iterator(cont, last, last); }
+    bool empty() const { return first == last; }
+};
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::ascending_groups() const -> GroupView {
+    const detail::IndexBuffer& idx = ascendingIndex();
+    return GroupView(this, idx.begin(), idx.end());
+}
+
+// — SetView —
+// Two cursors walk the cached ascending orders like std::set_* do. settle()
+// advances to the next element to emit (or to the end) and records which side
+// it comes from; equal elements emitted once by union/intersection advance both.
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::SetView {
+public:
+    enum class Op { Intersection, Union, Difference, SymmetricDifference };
+
+private:
+    const MyContainer* a;
+    const MyContainer* b;
+    Op op;
+
+public:
+    class iterator {
+        enum class Side { A, B, Both };
+
+        const MyContainer* a;
+        const MyContainer* b;
+        Op op;
+        const std::size_t* pa;
+        const std::size_t* ea;
+        const std::size_t* pb;
+        const std::size_t* eb;
+        Side side = Side::A;
+
+        void settle() {
+            while (pa != ea || pb != eb) {
+                if (pb == eb) {
+                    if (op == Op::Intersection) break;
+                    side = Side::A;
+                    return;
+                }
+                if (pa == ea) {
+                    if (op == Op::Intersection || op == Op::Difference) break;
+                    side = Side::B;
+                    return;
+                }
+                const T& x = a->data[*pa];
+                const T& y = b->data[*pb];
+                if (x < y) {
+                    if (op == Op::Intersection) { ++pa; continue; }
+                    side = Side::A;
+                    return;
+                }
+                if (y < x) {
+                    if (op == Op::Intersection || op == Op::Difference) { ++pb; continue; }
+                    side = Side::B;
+                    return;
+                }
+                if (op == Op::Intersection || op == Op::Union) {
+                    side = Side::Both;
+                    return;
+                }
+                ++pa;
+                ++pb;
+            }
+            pa = ea;   // one canonical end position
+            pb = eb;
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        iterator(const MyContainer* x, const MyContainer* y, Op o,
+                 const std::size_t* fa, const std::size_t* la,
+                 const std::size_t* fb, const std::size_t* lb)
+            : a(x), b(y), op(o), pa(fa), ea(la), pb(fb), eb(lb) { settle(); }
+
+        iterator& operator++() {
+            if (side != Side::B) ++pa;
+            if (side != Side::A) ++pb;
+            settle();
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return pa==o.pa && pb==o.pb; }
+        bool operator!=(const iterator& o) const { return !(*this==o); }
+        T operator*() const { return side == Side::B ? b->data[*pb] : a->data[*pa]; }
+    };
+
+    SetView(const MyContainer* x, const MyContainer* y, Op o) : a(x), b(y), op(o) {
+        a->ascendingIndex();
+        b->ascendingIndex();
+    }
+
+    iterator begin() const {
+        const detail::IndexBuffer& ia = a->ascendingIndex();
+        const detail::IndexBuffer& ib = b->ascendingIndex();
+        return iterator(a, b, op, ia.begin(), ia.end(), ib.begin(), ib.end());
+    }
+    iterator end() const {
+        const detail::IndexBuffer& ia = a->ascendingIndex();
+        const detail::IndexBuffer& ib = b->ascendingIndex();
+        return iterator(a, b, op, ia.end(), ia.end(), ib.end(), ib.end());
+    }
+    bool empty() const { return begin() == end(); }
+};
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::intersection_with(const MyContainer& other) const -> SetView {
+    return SetView(this, &other, SetView::Op::Intersection);
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::union_with(const MyContainer& other) const -> SetView {
+    return SetView(this, &other, SetView::Op::Union);
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::difference_with(const MyContainer& other) const -> SetView {
+    return SetView(this, &other, SetView::Op::Difference);
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::symmetric_difference_with(const MyContainer& other) const -> SetView {
+    return SetView(this, &other, SetView::Op::SymmetricDifference);
+}
+
+// — MergedView —
+// One cursor per non-empty shard sits in a binary heap ordered by the element
+// it points at (ties by shard position); each step pops the front cursor,
+// advances it and pushes it back while it has elements left.
+template<typename T, std::size_t InlineN>
+class MyContainer<T, InlineN>::MergedView {
+    std::vector<const MyContainer*> shards;
+    bool descending;
+
+public:
+    class iterator {
+        struct Cursor {
+            const MyContainer* cont;
+            const std::size_t* pos;   ///< Next index (descending: one past it).
+            const std::size_t* stop;
+            std::size_t shard;
+            // A plain bool for MyContainer<bool>, a reference into data otherwise.
+            typename std::pmr::vector<T>::const_reference value(bool desc) const {
+                return cont->data[desc ? pos[-1] : *pos];
+            }
+        };
+
+        std::vector<Cursor> heap;
+        std::size_t remaining = 0;
+        bool descending = false;
+
+        // "a comes after b": the heap keeps the cursor that comes first on top.
+        bool after(const Cursor& a, const Cursor& b) const {
+            const auto& x = a.value(descending);
+            const auto& y = b.value(descending);
+            if (descending ? x < y : y < x) return true;
+            if (descending ? y < x : x < y) return false;
+            return b.shard < a.shard;
+        }
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = T;
+
+        iterator() = default;   // end
+
+        iterator(const std::vector<const MyContainer*>& shards, bool desc) : descending(desc) {
+            for (std::size_t s = 0; s < shards.size(); ++s) {
+                if (!shards[s] || shards[s]->data.empty()) continue;
+                const detail::IndexBuffer& idx = shards[s]->ascendingIndex();
+                heap.push_back(desc ? Cursor{shards[s], idx.end(), idx.begin(), s}
+                                    : Cursor{shards[s], idx.begin(), idx.end(), s});
+                remaining += idx.size();
+            }
+            std::make_heap(heap.begin(), heap.end(), [this](const Cursor& a, const Cursor& b) { return after(a, b); });
+        }
+
+        iterator& operator++() {
+            auto cmp = [this](const Cursor& a, const Cursor& b) { return after(a, b); };
+            std::pop_heap(heap.begin(), heap.end(), cmp);
+            Cursor& c = heap.back();
+            descending ? --c.pos : ++c.pos;
+            if (c.pos == c.stop) heap.pop_back();
+            else std::push_heap(heap.begin(), heap.end(), cmp);
+            --remaining;
+            return *this;
+        }
+        bool operator==(const iterator& o) const { return remaining==o.remaining; }
+        bool operator!=(const iterator& o) const { return !(*this==o); }
+        T operator*() const {
+            if (heap.empty()) throw std::out_of_range("MergedView::iterator");
+            return heap.front().value(descending);
+        }
+    };
+
+    MergedView(const std::vector<const MyContainer*>& s, bool desc) : shards(s), descending(desc) {}
+
+    iterator begin() const { return iterator(shards, descending); }
+    iterator end() const { return iterator(); }
+};
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::merged_ascending(const std::vector<const MyContainer*>& shards) -> MergedView {
+    return MergedView(shards, false);
+}
+
+template<typename T, std::size_t InlineN>
+auto MyContainer<T, InlineN>::merged_descending(const std::vector<const MyContainer*>& shards) -> MergedView {
+    return MergedView(shards, true);
+}
+
 } // namespace ariel
@@ -9,19 +9,161 @@
  */
 
 #include <vector>
+#include <memory_resource>
 #include <cstddef>
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
 #include <numeric>
+#include <functional>
+#include <utility>
+#include <atomic>
+#include <mutex>
+#include "SortEngine.hpp"
+#include "QuantileSketch.hpp"
 
 namespace ariel {
 
+namespace detail {
+
+/**
+ * @class InlineArena
+ * @brief Memory resource with one in-object slot of Bytes bytes.
+ *
+ * The first request that fits gets the slot; everything else (and any
+ * request while the slot is taken) goes to the upstream resource.
+ */
+template<std::size_t Bytes, std::size_t Align>
+class InlineArena : public std::pmr::memory_resource {
+public:
+    explicit InlineArena(std::pmr::memory_resource* up) noexcept : upstream(up) {}
+    InlineArena(const InlineArena&) = delete;
+    InlineArena& operator=(const InlineArena&) = delete;
+
+    std::pmr::memory_resource* upstream_resource() const noexcept { return upstream; }
+
+private:
+    alignas(Align) unsigned char slot[Bytes];
+    bool used = false;
+    std::pmr::memory_resource* upstream;
+
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        if (!used && bytes <= Bytes && align <= Align) {
+            used = true;
+            return slot;
+        }
+        return upstream->allocate(bytes, align);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        if (p == static_cast<void*>(slot)) used = false;
+        else upstream->deallocate(p, bytes, align);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+        return this == &o;
+    }
+};
+
+// Size and alignment of the block std::pmr::vector<T> requests for N elements.
+template<typename T, std::size_t N>
+struct InlineFootprint {
+    static constexpr std::size_t bytes = N * sizeof(T);
+    static constexpr std::size_t align = alignof(T);
+};
+
+// vector<bool> packs bits into words of an unspecified unsigned type (unsigned
+// long in libstdc++, size_t in libc++, unsigned int in MSVC); size_t words
+// cover all of them.
+template<std::size_t N>
+struct InlineFootprint<bool, N> {
+    static constexpr std::size_t wordBits = 8 * sizeof(std::size_t);
+    static constexpr std::size_t bytes = (N + wordBits - 1) / wordBits * sizeof(std::size_t);
+    static constexpr std::size_t align = alignof(std::size_t);
+};
+
+/**
+ * @struct OrderCache
+ * @brief Cached ascending permutation of a MyContainer and the lock for filling it.
+ */
+struct OrderCache {
+    IndexBuffer index;
+    std::atomic<bool> valid{false};  ///< index matches the data (set last when filled).
+    std::mutex fill;                 ///< Serialises fills from const members.
+
+    explicit OrderCache(std::pmr::memory_resource* r) noexcept : index(r) {}
+};
+
+// Base of MyContainer holding the inline arena and an inline order cache, so
+// short containers sort without allocating. With InlineN == 0 it holds only
+// the resource, and the cache is allocated on first use.
+template<typename T, std::size_t InlineN>
+class ArenaHolder {
+protected:
+    explicit ArenaHolder(std::pmr::memory_resource* up) noexcept : arena(up), cacheSlot(up) {}
+    std::pmr::memory_resource* storageResource() noexcept { return &arena; }
+    std::pmr::memory_resource* upstreamResource() const noexcept { return arena.upstream_resource(); }
+    OrderCache* inlineCache() noexcept { return &cacheSlot; }
+
+private:
+    InlineArena<InlineFootprint<T, InlineN>::bytes, InlineFootprint<T, InlineN>::align> arena;
+    OrderCache cacheSlot;
+};
+
+template<typename T>
+class ArenaHolder<T, 0> {
+protected:
+    explicit ArenaHolder(std::pmr::memory_resource* up) noexcept : upstream(up) {}
+    std::pmr::memory_resource* storageResource() noexcept { return upstream; }
+    std::pmr::memory_resource* upstreamResource() const noexcept { return upstream; }
+    OrderCache* inlineCache() noexcept { return nullptr; }
+
+private:
+    std::pmr::memory_resource* upstream;
+};
+
+} // namespace detail
+
+/**
+ * @enum Traversal
+ * @brief Names one of MyContainer's six iteration orders.
+ */
+enum class Traversal {
+    Ascending,   ///< Smallest to largest.
+    Descending,  ///< Largest to smallest.
+    SideCross,   ///< Smallest, largest, 2nd smallest, 2nd largest, …
+    Reverse,     ///< Reverse insertion order.
+    Insertion,   ///< Insertion order.
+    MiddleOut    ///< Middle, left of middle, right of middle, …
+};
+
 /**
  * @class MyContainer
  * @brief A generic container supporting six distinct iteration orders.
  *
  * @tparam T The type of elements stored; requires operator< and operator==.
+ * @tparam InlineN Elements kept inside the object before spilling to the heap
+ *         (0, the default, always uses the memory resource).
+ *
+ * The sorted traversals and removeElement() also accept a comparator and a
+ * projection per call (e.g. `begin_ascending_order(std::less<>{}, &Point::x)`),
+ * so a type can be ordered by one of its fields without a wrapper type. Both
+ * are template parameters, so stateless functors are inlined into the sort.
+ * Types with a sort_key specialisation are ordered by cached integer keys.
+ *
+ * Element storage and every internal permutation or scratch buffer come from
+ * one std::pmr::memory_resource chosen at construction, so a container built
+ * on an arena is released together with it. Copies allocate from the default
+ * resource, as std::pmr containers do.
+ *
+ * The natural-order (operator<) ascending permutation is cached once built,
+ * which makes order-statistic queries O(1)/O(log n). The cache lives inside
+ * the object when InlineN > 0 and is allocated from the resource on first use
+ * otherwise. Const members may fill it; the fill is guarded by a mutex, so any
+ * number of threads may use const members of one container concurrently.
+ * Modifying members still need exclusive access, as for standard containers.
+ * enable_sketch() additionally keeps a QuantileSketch up to date, for
+ * approximate ranks and quantiles whose cost depends only on the sketch size.
  *
  * Features:
  *  - addElement() / removeElement()
@@ -29,21 +171,177 @@ namespace ariel {
  *  - operator<< for streaming
  *  - Ascending, Descending, Side-Cross, Reverse, Insertion, Middle-Out iterators
  */
-template<typename T>
-class MyContainer {
+template<typename T, std::size_t InlineN = 0>
+class MyContainer : private detail::ArenaHolder<T, InlineN> {
 private:
-    std::vector<T> data;  ///< Underlying storage for elements.
+    using ArenaBase = detail::ArenaHolder<T, InlineN>;
+
+    std::pmr::vector<T> data;  ///< Underlying storage for elements (inline while size() <= InlineN).
+    bool insertionSorted = true;  ///< data is already non-descending under operator<.
+    /// Cached ascending order: the inline slot when InlineN > 0, otherwise null
+    /// until orderCache() allocates it from the resource.
+    mutable std::atomic<detail::OrderCache*> cache;
+
+    /// Sketches of every element added and removed; approx answers use their difference.
+    struct Sketches {
+        QuantileSketch<T> added, removed;
+        /// (added item, net elements up to and including it), ascending; built on
+        /// demand under cdfMutex and dropped by every modification.
+        mutable std::pmr::vector<std::pair<T, double>> cdf;
+        mutable bool cdfValid = false;
+
+        Sketches(std::size_t k, std::pmr::memory_resource* r) : added(k, r), removed(k, r), cdf(r) {}
+        Sketches(const Sketches& o, std::pmr::memory_resource* r)
+            : added(o.added, r), removed(o.removed, r), cdf(r) {}
+        Sketches(const Sketches&) = delete;   // cdf may be filling; copy with a resource instead
+
+        void add(const T& x) { added.update(x); cdfValid = false; }
+        void remove(const T& x) { removed.update(x); cdfValid = false; }
+
+        mutable std::mutex cdfMutex;  ///< Serialises cdf builds from const members.
+    };
+    /// Allocated from the container's resource by enable_sketch(); null until then,
+    /// so a container without a sketch pays one pointer.
+    Sketches* sketches = nullptr;
+
+    /**
+     * @brief Replace the sketches with Sketches(args...) allocated from get_resource().
+     */
+    template<typename... Args>
+    void emplaceSketches(Args&&... args);
+
+    /**
+     * @brief Destroy the sketches, if any, and return their memory to get_resource().
+     */
+    void dropSketches() noexcept;
+
+    /**
+     * @brief Rebuild the sketches from data once removals exceed size() / 4.
+     */
+    void refreshSketch();
+
+    /**
+     * @brief The cached ascending permutation, built on first use.
+     *
+     * Valid until the next removeElement(); addElement() keeps it valid when the
+     * new element is not smaller than the current maximum.
+     */
+    const detail::IndexBuffer& ascendingIndex() const;
+
+    /**
+     * @brief The order cache, allocated on first use (safe from concurrent const calls).
+     */
+    detail::OrderCache& orderCache() const;
+
+    /**
+     * @brief The order cache if it holds a valid order, otherwise null.
+     */
+    detail::OrderCache* validCache() const noexcept;
+
+    /**
+     * @brief Mark the cached order stale (modifying members only).
+     */
+    void invalidateCache() noexcept;
+
+    /**
+     * @brief Return an allocated order cache to the resource.
+     */
+    void releaseCache() noexcept;
+
+    /**
+     * @brief Take other's cached order, leaving other without a valid one.
+     */
+    void takeCacheFrom(MyContainer& other);
+
+    /**
+     * @brief Slice [first, last) of the cached ascending order with lo <= x <= hi.
+     */
+    std::pair<const std::size_t*, const std::size_t*> valueBounds(const T& lo, const T& hi) const;
+
+    /**
+     * @brief Fill idx with the k first indices under `before`, in that order (no cache).
+     */
+    template<typename Before>
+    void selectFirst(std::size_t k, Before before, detail::IndexBuffer& idx) const;
+
+    /**
+     * @brief Insertion index at position k of the middle-out order of n elements.
+     */
+    static std::size_t middleOutIndex(std::size_t n, std::size_t k);
+
+    /**
+     * @brief Elements at the given ascending ranks (each < size(), any order).
+     */
+    std::vector<T> valuesAtRanks(const std::vector<std::size_t>& ranks) const;
+
+    /**
+     * @brief Ascending rank (or, for unsorted traversals, insertion index) at position k.
+     */
+    static std::size_t positionSource(Traversal order, std::size_t n, std::size_t k);
+
+    /**
+     * @brief Replace data with [first, last), reserving the inline slot first.
+     */
+    template<typename It>
+    void assignFrom(It first, It last);
+
+    /**
+     * @brief Take other's cached order if it is complete; otherwise leave ours invalid.
+     */
+    void copyCacheFrom(const MyContainer& other);
+
+    /**
+     * @brief Fill order with the ascending permutation of data under comp∘proj.
+     *
+     * Skips sorting when elements were added in non-descending order.
+     */
+    template<typename Compare, typename Projection>
+    void buildAscending(detail::IndexBuffer& order, Compare& comp, Projection& proj) const;
 
 public:
     /**
-     * @brief Default constructor.
+     * @brief Default constructor; allocates from std::pmr::get_default_resource().
      */
-    MyContainer() = default;
+    MyContainer() : MyContainer(std::pmr::get_default_resource()) {}
 
     /**
-     * @brief Default destructor.
+     * @brief Construct a container whose storage and ordering buffers use resource.
+     * @param resource Memory resource; must outlive the container and its iterators.
      */
-    ~MyContainer() = default;
+    explicit MyContainer(std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Copy constructor; the copy allocates from the default resource.
+     */
+    MyContainer(const MyContainer& other);
+
+    /**
+     * @brief Move constructor; keeps other's resource (elements move one by one
+     *        when InlineN > 0, since other's inline slot cannot be taken over).
+     *
+     * Never throws when InlineN == 0, so std::vector<MyContainer> moves rather
+     * than copies on reallocation and each element keeps its resource.
+     */
+    MyContainer(MyContainer&& other) noexcept(InlineN == 0);
+
+    /**
+     * @brief Copy assignment; keeps this container's resource.
+     */
+    MyContainer& operator=(const MyContainer& other);
+
+    /**
+     * @brief Move assignment; keeps this container's resource.
+     *
+     * Steals other's storage and cached order when both use the same resource;
+     * otherwise elements are moved one by one into this container's resource,
+     * which may allocate (as for std::pmr::vector, so this is not noexcept).
+     */
+    MyContainer& operator=(MyContainer&& other);
+
+    /**
+     * @brief Destructor; returns the sketch and order cache, if any, to the resource.
+     */
+    ~MyContainer();
 
     /**
      * @brief Add an element to the container.
@@ -58,12 +356,175 @@ public:
      */
     void removeElement(const T& elem);
 
+    /**
+     * @brief Remove all elements whose projection equals key.
+     * @param key Value compared (with operator==) against each projected element.
+     * @param proj Projection applied to each element, e.g. `&Point::x`.
+     * @throws std::runtime_error if no element matches.
+     */
+    template<typename Key, typename Projection>
+    void removeElement(const Key& key, Projection proj);
+
+    /**
+     * @brief Move all of other's elements to the end of this container.
+     * @param other Source container; left empty (and without a sketch).
+     * @throws std::invalid_argument if other is this container.
+     *
+     * Both ascending orders (cached, or built now) are combined by one linear
+     * merge, so the result starts with a valid cached order and no re-sort.
+     * Ties keep this container's elements first. If this container has a
+     * sketch, other's sketch is merged into it (or other's elements are fed in
+     * when other has none or a different k).
+     */
+    void merge(MyContainer&& other);
+
+    /**
+     * @brief Split the elements into pivots.size() + 1 containers by value.
+     * @param pivots Non-descending split points; part j receives the elements x
+     *        with pivots[j-1] <= x < pivots[j] (unbounded at either end).
+     * @return The parts, each on this container's resource, in insertion order.
+     * @throws std::invalid_argument if pivots is not sorted.
+     *
+     * Elements are moved, leaving this container empty. Each element is placed
+     * by binary search over the pivots, O(n log k); when the ascending order is
+     * cached it is instead walked once, and every part receives its slice of it
+     * as a ready-made cache. Parts get a sketch if this container had one.
+     */
+    std::vector<MyContainer> split_by_pivots(const std::vector<T>& pivots);
+
     /**
      * @brief Get the number of elements in the container.
      * @return Current size.
      */
     std::size_t size() const;
 
+    /**
+     * @brief Memory resource used for elements and internal buffers.
+     * @return The resource given at construction (or the default resource);
+     *         with InlineN > 0 it backs elements that do not fit inline.
+     */
+    std::pmr::memory_resource* get_resource() const;
+
+    /**
+     * @brief The k-th smallest element (0-based).
+     * @param k Rank, 0 for the minimum.
+     * @return Copy of the element; O(1) once the ascending order is cached, O(n) otherwise.
+     * @throws std::out_of_range if k >= size().
+     */
+    T nth_smallest(std::size_t k) const;
+
+    /**
+     * @brief Number of elements strictly smaller than x.
+     * @param x Probe value (need not be in the container).
+     * @return Rank of x; O(log n) once the ascending order is cached, O(n) otherwise.
+     */
+    std::size_t rank(const T& x) const;
+
+    /**
+     * @brief The lower median, i.e. nth_smallest((size()-1)/2).
+     * @return Copy of the median element.
+     * @throws std::out_of_range if the container is empty.
+     */
+    T median() const;
+
+    /**
+     * @brief Start maintaining an approximate quantile sketch of the contents.
+     * @param k Sketch accuracy (see QuantileSketch::k_for_error); the normalised
+     *        rank error is about 1.65% for k = 200, and at most 1.5 times that
+     *        while removals are pending.
+     *
+     * Feeds the current elements in, then follows every addElement() and
+     * removeElement(). Removals go to a second sketch that is subtracted, so
+     * once they exceed size() / 4 the sketch is rebuilt from the elements.
+     * Calling it again rebuilds the sketch with the new k.
+     */
+    void enable_sketch(std::size_t k = 200);
+
+    /**
+     * @brief Whether enable_sketch() has been called.
+     */
+    bool has_sketch() const noexcept;
+
+    /**
+     * @brief Approximate number of elements strictly smaller than x.
+     * @throws std::logic_error if no sketch is enabled.
+     */
+    double approx_rank(const T& x) const;
+
+    /**
+     * @brief Approximate element at normalised rank q, from the sketch alone.
+     * @param q Fraction in [0, 1], e.g. 0.99 for the p99.
+     *
+     * The first call after a modification merges the two sketches' retained
+     * items into a cumulative table (O(k log k), on the container's resource);
+     * further calls binary-search it, O(log k) with no allocation.
+     * @throws std::logic_error if no sketch is enabled.
+     * @throws std::out_of_range if the container is empty or q is outside [0, 1].
+     */
+    T approx_quantile(double q) const;
+
+    /**
+     * @brief Elements at the given quantiles.
+     * @param qs Fractions in [0, 1], in any order; q maps to rank floor(q * (size()-1)).
+     * @return One element per entry of qs, in the same order.
+     * @throws std::out_of_range if a q lies outside [0, 1], or if qs is non-empty
+     *         and the container is empty.
+     *
+     * Reads the cached ascending order when it exists; otherwise the requested
+     * ranks are found by multi-select in O(n log q) without sorting.
+     */
+    std::vector<T> quantiles(const std::vector<double>& qs) const;
+
+    /**
+     * @brief Every stride-th element of the ascending order (ranks 0, stride, 2*stride, …).
+     * @param stride Distance between sampled ranks, e.g. size()/100 for percentiles.
+     * @return The sampled elements, ascending.
+     * @throws std::invalid_argument if stride is 0.
+     */
+    std::vector<T> sample_every(std::size_t stride) const;
+
+    /**
+     * @brief Write the k smallest elements, smallest first.
+     * @param k Number of elements wanted (clamped to size()).
+     * @param out Output iterator receiving copies of the elements.
+     * @return out advanced past the last element written.
+     *
+     * Reads the cached ascending order when it exists. Otherwise a bounded heap
+     * streams over the data when k is much smaller than n (O(n log k)), and
+     * nth_element plus a sort of the first k is used for larger k (O(n + k log k)).
+     */
+    template<typename OutputIt>
+    OutputIt bottom_k(std::size_t k, OutputIt out) const;
+
+    /**
+     * @brief Write the k largest elements, largest first.
+     * @param k Number of elements wanted (clamped to size()).
+     * @param out Output iterator receiving copies of the elements.
+     * @return out advanced past the last element written.
+     */
+    template<typename OutputIt>
+    OutputIt top_k(std::size_t k, OutputIt out) const;
+
+    /**
+     * @brief Elements on one page of a traversal.
+     * @param order Which of the six orders to page through.
+     * @param page Zero-based page number.
+     * @param pageSize Elements per page.
+     * @return Elements at positions [page*pageSize, (page+1)*pageSize) of the order
+     *         (fewer on the last page, none past the end).
+     *
+     * Sorted orders read the cached ascending order when it exists; otherwise
+     * only the ranks on the page are selected with nth_element and sorted,
+     * O(n + pageSize log pageSize), so deep pages cost the same as shallow ones.
+     */
+    std::vector<T> page(Traversal order, std::size_t page, std::size_t pageSize) const;
+
+    /**
+     * @brief Copy of the elements sorted ascending, without an index permutation.
+     * @return Sorted values, contiguous; equal elements carry no insertion provenance.
+     */
+    std::vector<T> sorted_values() const;
+
     /**
      * @brief Stream output operator.
      * @param os Output stream.
@@ -72,7 +533,7 @@ public:
      *
      * Prints elements in insertion order, e.g. "[ a b c ]".
      */
-    friend std::ostream& operator<<(std::ostream& os, const MyContainer<T>& cont) {
+    friend std::ostream& operator<<(std::ostream& os, const MyContainer& cont) {
         os << "[ ";
         for (const auto& e : cont.data) {
             os << e << " ";
@@ -87,6 +548,22 @@ public:
     class ReverseIterator;      ///< Iterates in reverse insertion order.
     class OrderIterator;        ///< Iterates in insertion order.
     class MiddleOutIterator;    ///< Starts at middle, then alternates left/right.
+    class RangeView;            ///< Slice of the cached ascending order, walked either way.
+    class GroupView;            ///< Runs of equal elements in the cached ascending order.
+    class SetView;              ///< Lazy merge of two cached ascending orders.
+    class MergedView;           ///< Lazy k-way merge of many containers' cached orders.
+
+    /**
+     * @brief One distinct value and the insertion indices of its copies.
+     */
+    struct Group {
+        /// The shared value: a reference into the container (a plain bool for
+        /// MyContainer<bool>, whose storage has no addressable elements).
+        typename std::pmr::vector<T>::const_reference value;
+        std::size_t count;          ///< Number of copies.
+        const std::size_t* first;   ///< Insertion indices of the copies, [first, last).
+        const std::size_t* last;
+    };
 
     /**
      * @brief Get iterator to beginning of ascending sequence.
@@ -100,6 +577,15 @@ public:
      */
     AscendingIterator  end_ascending_order()   const;
 
+    /**
+     * @brief Get iterator to beginning of ascending sequence under a custom ordering.
+     * @param comp Strict weak ordering applied to projected elements.
+     * @param proj Projection applied to each element before comparing.
+     * @return AscendingIterator at first element; compares equal to end_ascending_order() at the end.
+     */
+    template<typename Compare, typename Projection = identity>
+    AscendingIterator begin_ascending_order(Compare comp, Projection proj = {}) const;
+
     /**
      * @brief Get iterator to beginning of descending sequence.
      * @return DescendingIterator at first element.
@@ -112,6 +598,15 @@ public:
      */
     DescendingIterator end_descending_order()   const;
 
+    /**
+     * @brief Get iterator to beginning of descending sequence under a custom ordering.
+     * @param comp Strict weak ordering in the ascending sense; traversal runs largest first.
+     * @param proj Projection applied to each element before comparing.
+     * @return DescendingIterator at first element; compares equal to end_descending_order() at the end.
+     */
+    template<typename Compare, typename Projection = identity>
+    DescendingIterator begin_descending_order(Compare comp, Projection proj = {}) const;
+
     /**
      * @brief Get iterator to beginning of side-cross sequence.
      * @return SideCrossIterator at first element.
@@ -124,6 +619,15 @@ public:
      */
     SideCrossIterator  end_side_cross_order()   const;
 
+    /**
+     * @brief Get iterator to beginning of side-cross sequence under a custom ordering.
+     * @param comp Strict weak ordering applied to projected elements.
+     * @param proj Projection applied to each element before comparing.
+     * @return SideCrossIterator at first element; compares equal to end_side_cross_order() at the end.
+     */
+    template<typename Compare, typename Projection = identity>
+    SideCrossIterator begin_side_cross_order(Compare comp, Projection proj = {}) const;
+
     /**
      * @brief Get iterator to beginning of reverse insertion sequence.
      * @return ReverseIterator at first element.
@@ -159,6 +663,64 @@ public:
      * @return MiddleOutIterator one past last.
      */
     MiddleOutIterator  end_middle_out_order()   const;
+
+    /**
+     * @brief Elements x with lo <= x <= hi, smallest first.
+     * @param lo Lower bound (inclusive).
+     * @param hi Upper bound (inclusive).
+     * @return View over the matching slice of the cached ascending order;
+     *         O(log n) to build, invalidated by addElement()/removeElement().
+     */
+    RangeView ascending_range(const T& lo, const T& hi) const;
+
+    /**
+     * @brief Elements x with lo <= x <= hi, largest first.
+     * @param lo Lower bound (inclusive).
+     * @param hi Upper bound (inclusive).
+     * @return View over the matching slice of the cached ascending order, walked backwards.
+     */
+    RangeView descending_range(const T& lo, const T& hi) const;
+
+    /**
+     * @brief Distinct values in ascending order, each with its count and indices.
+     * @return View yielding one Group per run of equal elements (neither a < b
+     *         nor b < a), computed in one pass over the cached ascending order;
+     *         invalidated by addElement()/removeElement().
+     */
+    GroupView ascending_groups() const;
+
+    /**
+     * @name Set operations
+     * Lazy views that merge this container's and other's cached ascending
+     * orders, yielding elements in ascending order with the multiset semantics
+     * of std::set_intersection and friends (an element occurring m times here
+     * and k times in other occurs min(m, k) times in the intersection, etc.).
+     * Nothing is copied or sorted beyond building the two caches; the views are
+     * invalidated by addElement()/removeElement() on either container.
+     * @{
+     */
+    SetView intersection_with(const MyContainer& other) const;
+    SetView union_with(const MyContainer& other) const;
+    SetView difference_with(const MyContainer& other) const;            ///< Elements of *this not in other.
+    SetView symmetric_difference_with(const MyContainer& other) const;
+    /** @} */
+
+    /**
+     * @brief All elements of several containers, smallest first.
+     * @param shards Containers to merge (null entries are skipped); they must
+     *        outlive the view and not be modified while it is in use.
+     * @return View merging the shards' cached ascending orders through a heap of
+     *         cursors: O(k) to start, O(log k) per element, nothing materialised.
+     *         Equal elements come in shard order.
+     */
+    static MergedView merged_ascending(const std::vector<const MyContainer*>& shards);
+
+    /**
+     * @brief All elements of several containers, largest first.
+     * @param shards Containers to merge (null entries are skipped).
+     * @return View walking the shards' cached ascending orders backwards.
+     */
+    static MergedView merged_descending(const std::vector<const MyContainer*>& shards);
 };
 
 } // namespace ariel
@@ -0,0 +1,212 @@
+#ifndef MYSTATICCONTAINER_HPP
+#define MYSTATICCONTAINER_HPP
+
+/**
+ * @file MyStaticContainer.hpp
+ * @brief Fixed-capacity, constexpr variant of MyContainer backed by std::array.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iostream>
+#include <stdexcept>
+
+namespace ariel {
+
+/**
+ * @class MyStaticContainer
+ * @brief Holds up to N elements in a std::array; every operation is constexpr.
+ *
+ * @tparam T Literal, default-constructible type; requires operator< and operator==.
+ * @tparam N Capacity.
+ *
+ * The six orders are returned as index permutations (std::array<std::size_t, N>,
+ * only the first size() entries are meaningful). Evaluated on a constexpr
+ * container they are computed by the compiler and can be used in static_assert.
+ */
+template<typename T, std::size_t N>
+class MyStaticContainer {
+public:
+    using Order = std::array<std::size_t, N>;  ///< Index permutation of the elements.
+
+private:
+    std::array<T, N> data{};  ///< Elements; only the first count are live.
+    std::size_t count = 0;     ///< Number of live elements.
+
+    // Stable bottom-up merge sort of the live indices (std::sort is not constexpr in C++17).
+    constexpr Order sortedIndices() const {
+        Order a{}, b{};
+        for (std::size_t i = 0; i < count; ++i) a[i] = i;
+        for (std::size_t width = 1; width < count; width *= 2) {
+            for (std::size_t lo = 0; lo < count; lo += 2 * width) {
+                const std::size_t mid = lo + width < count ? lo + width : count;
+                const std::size_t hi = lo + 2 * width < count ? lo + 2 * width : count;
+                std::size_t i = lo, j = mid, k = lo;
+                while (i < mid && j < hi) b[k++] = (data[a[j]] < data[a[i]]) ? a[j++] : a[i++];
+                while (i < mid) b[k++] = a[i++];
+                while (j < hi) b[k++] = a[j++];
+            }
+            for (std::size_t i = 0; i < count; ++i) a[i] = b[i];
+        }
+        return a;
+    }
+
+public:
+    /**
+     * @brief Default constructor: empty container.
+     */
+    constexpr MyStaticContainer() = default;
+
+    /**
+     * @brief Construct from a list of elements, in insertion order.
+     * @throws std::length_error if the list holds more than N elements.
+     */
+    constexpr MyStaticContainer(std::initializer_list<T> init) {
+        for (const T& e : init) addElement(e);
+    }
+
+    /**
+     * @brief Add an element to the container.
+     * @param elem The element to add.
+     * @throws std::length_error if the container is full.
+     */
+    constexpr void addElement(const T& elem) {
+        if (count == N) throw std::length_error("MyStaticContainer is full");
+        data[count++] = elem;
+    }
+
+    /**
+     * @brief Remove all occurrences of an element.
+     * @param elem The element to remove.
+     * @throws std::runtime_error if the element is not found.
+     */
+    constexpr void removeElement(const T& elem) {
+        std::size_t w = 0;
+        for (std::size_t r = 0; r < count; ++r) {
+            if (!(data[r] == elem)) data[w++] = data[r];
+        }
+        if (w == count) throw std::runtime_error("Element not found");
+        count = w;
+    }
+
+    /**
+     * @brief Get the number of elements in the container.
+     * @return Current size.
+     */
+    constexpr std::size_t size() const { return count; }
+
+    /**
+     * @brief Get the fixed capacity.
+     * @return N.
+     */
+    static constexpr std::size_t capacity() { return N; }
+
+    /**
+     * @brief Element at an insertion position.
+     * @throws std::out_of_range if i >= size().
+     */
+    constexpr const T& at(std::size_t i) const {
+        if (i >= count) throw std::out_of_range("MyStaticContainer::at");
+        return data[i];
+    }
+
+    /// Smallest to largest (stable).
+    constexpr Order ascending_order() const { return sortedIndices(); }
+
+    /// Largest to smallest (the ascending order reversed).
+    constexpr Order descending_order() const {
+        const Order asc = sortedIndices();
+        Order o{};
+        for (std::size_t i = 0; i < count; ++i) o[i] = asc[count - 1 - i];
+        return o;
+    }
+
+    /// Smallest, largest, 2nd smallest, 2nd largest, …
+    constexpr Order side_cross_order() const {
+        const Order asc = sortedIndices();
+        Order o{};
+        for (std::size_t k = 0; k < count; ++k) o[k] = (k % 2) ? asc[count - 1 - k / 2] : asc[k / 2];
+        return o;
+    }
+
+    /// Reverse insertion order.
+    constexpr Order reverse_order() const {
+        Order o{};
+        for (std::size_t i = 0; i < count; ++i) o[i] = count - 1 - i;
+        return o;
+    }
+
+    /// Insertion order.
+    constexpr Order insertion_order() const {
+        Order o{};
+        for (std::size_t i = 0; i < count; ++i) o[i] = i;
+        return o;
+    }
+
+    /// Middle, left of middle, right of middle, …
+    constexpr Order middle_out_order() const {
+        Order o{};
+        const std::size_t mid = count / 2;
+        for (std::size_t k = 0; k < count; ++k) {
+            o[k] = (k == 0) ? mid : (k % 2) ? mid - (k + 1) / 2 : mid + k / 2;
+        }
+        return o;
+    }
+
+    /**
+     * @brief Stream output operator; prints elements in insertion order, e.g. "[ a b c ]".
+     */
+    friend std::ostream& operator<<(std::ostream& os, const MyStaticContainer& cont) {
+        os << "[ ";
+        for (std::size_t i = 0; i < cont.count; ++i) os << cont.data[i] << " ";
+        return os << "]";
+    }
+
+    /**
+     * @class Iterator
+     * @brief Walks one of the permutations above; carries its own copy of it.
+     */
+    class Iterator {
+        const MyStaticContainer* cont;
+        Order order;
+        std::size_t index;
+
+    public:
+        constexpr Iterator(const MyStaticContainer* c, const Order& o, std::size_t i)
+            : cont(c), order(o), index(i) {}
+
+        constexpr Iterator& operator++() { ++index; return *this; }
+        constexpr bool operator==(const Iterator& o) const {
+            return cont==o.cont && index==o.index;
+        }
+        constexpr bool operator!=(const Iterator& o) const { return !(*this==o); }
+        constexpr const T& operator*() const {
+            if (index >= cont->count) throw std::out_of_range("MyStaticContainer::Iterator");
+            return cont->data[order[index]];
+        }
+    };
+
+    constexpr Iterator begin_ascending_order() const { return Iterator(this, ascending_order(), 0); }
+    constexpr Iterator end_ascending_order() const { return end(); }
+    constexpr Iterator begin_descending_order() const { return Iterator(this, descending_order(), 0); }
+    constexpr Iterator end_descending_order() const { return end(); }
+    constexpr Iterator begin_side_cross_order() const { return Iterator(this, side_cross_order(), 0); }
+    constexpr Iterator end_side_cross_order() const { return end(); }
+    constexpr Iterator begin_reverse_order() const { return Iterator(this, reverse_order(), 0); }
+    constexpr Iterator end_reverse_order() const { return end(); }
+    constexpr Iterator begin_order() const { return Iterator(this, insertion_order(), 0); }
+    constexpr Iterator end_order() const { return end(); }
+    constexpr Iterator begin_middle_out_order() const { return Iterator(this, middle_out_order(), 0); }
+    constexpr Iterator end_middle_out_order() const { return end(); }
+
+private:
+    // End iterators only compare by index, so they carry an empty permutation.
+    constexpr Iterator end() const { return Iterator(this, Order{}, count); }
+};
+
+} // namespace ariel
+
+#endif // MYSTATICCONTAINER_HPP
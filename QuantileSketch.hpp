@@ -0,0 +1,211 @@
+#ifndef QUANTILESKETCH_HPP
+#define QUANTILESKETCH_HPP
+
+/**
+ * @file QuantileSketch.hpp
+ * @brief Mergeable streaming quantile sketch (KLL) for approximate rank queries.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <memory_resource>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+namespace ariel {
+
+/**
+ * @class QuantileSketch
+ * @brief KLL sketch: approximate ranks and quantiles of a stream in O(k) memory.
+ *
+ * Items enter level 0; a full level is sorted and every other item moves up one
+ * level with twice the weight. Level capacities shrink by 2/3 per level below
+ * the top, so memory stays around 3k items however long the stream is. Rank
+ * queries scan the retained items, so their cost depends on k but not on the
+ * number of items seen. The normalised rank error is about error_bound()
+ * (≈1.65% for k = 200) with high probability.
+ *
+ * Compaction coin flips come from a fixed-seed generator, so results are
+ * reproducible. Sketches built with the same k can be merged. All storage
+ * comes from the memory resource given at construction.
+ *
+ * @tparam T Item type (copyable).
+ * @tparam Compare Strict weak order on T.
+ */
+template<typename T, typename Compare = std::less<>>
+class QuantileSketch {
+public:
+    /**
+     * @brief Empty sketch.
+     * @param k Accuracy parameter (top-level capacity), at least 8.
+     * @param resource Source of the sketch's storage.
+     * @throws std::invalid_argument if k < 8.
+     */
+    explicit QuantileSketch(std::size_t k = 200,
+                            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : kParam(k), levels(1, resource), maxRetained(k) {
+        if (k < 8) throw std::invalid_argument("QuantileSketch: k must be at least 8");
+    }
+
+    /**
+     * @brief Copy of other whose storage comes from resource.
+     */
+    QuantileSketch(const QuantileSketch& other, std::pmr::memory_resource* resource)
+        : kParam(other.kParam), levels(other.levels, resource), n(other.n), retained(other.retained),
+          maxRetained(other.maxRetained), rng(other.rng), comp(other.comp) {}
+
+    QuantileSketch(const QuantileSketch&) = default;
+    QuantileSketch(QuantileSketch&&) = default;
+    QuantileSketch& operator=(const QuantileSketch&) = default;
+    QuantileSketch& operator=(QuantileSketch&&) = default;
+
+    /// Memory resource backing the sketch.
+    std::pmr::memory_resource* get_resource() const noexcept { return levels.get_allocator().resource(); }
+
+    /**
+     * @brief Smallest k whose error_bound() is at most eps.
+     * @throws std::invalid_argument if eps is not in (0, 1).
+     */
+    static std::size_t k_for_error(double eps) {
+        if (!(eps > 0.0 && eps < 1.0)) throw std::invalid_argument("QuantileSketch: eps outside (0, 1)");
+        auto k = static_cast<std::size_t>(std::ceil(std::pow(kErrorScale / eps, 1.0 / kErrorExponent)));
+        return std::max<std::size_t>(k, 8);
+    }
+
+    /// Approximate normalised rank error for this k (empirical KLL fit).
+    double error_bound() const { return kErrorScale / std::pow(static_cast<double>(kParam), kErrorExponent); }
+
+    std::size_t k() const noexcept { return kParam; }
+
+    /// Number of items fed in (including merged sketches).
+    std::uint64_t count() const noexcept { return n; }
+
+    bool empty() const noexcept { return n == 0; }
+
+    /// Adds one item.
+    void update(const T& x) {
+        levels[0].push_back(x);
+        ++n;
+        if (++retained >= maxRetained) compress();
+    }
+
+    /**
+     * @brief Folds another sketch into this one.
+     * @throws std::invalid_argument if the two sketches use different k.
+     */
+    void merge(const QuantileSketch& other) {
+        if (other.kParam != kParam) throw std::invalid_argument("QuantileSketch: merging different k");
+        if (other.levels.size() > levels.size()) {
+            levels.resize(other.levels.size());
+            maxRetained = capacityTotal();
+        }
+        for (std::size_t h = 0; h < other.levels.size(); ++h) {
+            levels[h].insert(levels[h].end(), other.levels[h].begin(), other.levels[h].end());
+        }
+        n += other.n;
+        retained += other.retained;
+        while (retained >= maxRetained) compress();
+    }
+
+    /// Estimated number of items strictly smaller than x.
+    double rank(const T& x) const {
+        std::uint64_t r = 0;
+        for (std::size_t h = 0; h < levels.size(); ++h) {
+            std::uint64_t below = 0;
+            for (const T& y : levels[h]) below += comp(y, x) ? 1 : 0;
+            r += below << h;
+        }
+        return static_cast<double>(r);
+    }
+
+    /**
+     * @brief Item whose estimated normalised rank is about q.
+     * @param q Fraction in [0, 1].
+     * @throws std::out_of_range if the sketch is empty or q is outside [0, 1].
+     */
+    T quantile(double q) const {
+        if (n == 0) throw std::out_of_range("quantile of empty sketch");
+        if (!(q >= 0.0 && q <= 1.0)) throw std::out_of_range("quantile outside [0, 1]");
+        auto items = weightedItems();
+        const double target = q * static_cast<double>(n);
+        std::uint64_t seen = 0;
+        for (const auto& [item, weight] : items) {
+            seen += weight;
+            if (static_cast<double>(seen) > target) return item;
+        }
+        return items.back().first;
+    }
+
+    /// Retained items with their weights, sorted by Compare (allocated from get_resource()).
+    std::pmr::vector<std::pair<T, std::uint64_t>> weightedItems() const {
+        std::pmr::vector<std::pair<T, std::uint64_t>> items(get_resource());
+        items.reserve(retained);
+        for (std::size_t h = 0; h < levels.size(); ++h) {
+            for (const T& y : levels[h]) items.emplace_back(y, std::uint64_t(1) << h);
+        }
+        std::sort(items.begin(), items.end(),
+                  [this](const auto& a, const auto& b) { return comp(a.first, b.first); });
+        return items;
+    }
+
+private:
+    static constexpr double kErrorScale = 2.446;      // eps ≈ 2.446 / k^0.9433
+    static constexpr double kErrorExponent = 0.9433;
+
+    std::size_t kParam;
+    std::pmr::vector<std::pmr::vector<T>> levels;   ///< levels[h] items each weigh 2^h.
+    std::uint64_t n = 0;
+    std::size_t retained = 0;
+    std::size_t maxRetained;              ///< Sum of level capacities; compaction threshold.
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull;
+    Compare comp;
+
+    std::size_t capacity(std::size_t h) const {
+        const std::size_t depth = levels.size() - 1 - h;
+        auto cap = static_cast<std::size_t>(std::ceil(static_cast<double>(kParam) * std::pow(2.0 / 3.0, depth)));
+        return std::max<std::size_t>(cap, 2);
+    }
+
+    std::size_t capacityTotal() const {
+        std::size_t total = 0;
+        for (std::size_t h = 0; h < levels.size(); ++h) total += capacity(h);
+        return total;
+    }
+
+    bool coin() {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng & 1;
+    }
+
+    // Compacts the lowest full level: sort it, promote every other item (random
+    // offset) one level up, and keep a leftover item when the count is odd.
+    void compress() {
+        for (std::size_t h = 0; h < levels.size(); ++h) {
+            if (levels[h].size() < capacity(h)) continue;
+            if (h + 1 == levels.size()) {
+                levels.emplace_back();
+                maxRetained = capacityTotal();
+            }
+            std::pmr::vector<T>& level = levels[h];
+            std::sort(level.begin(), level.end(), std::ref(comp));
+            const std::size_t pairs = level.size() / 2;
+            const std::size_t offset = coin() ? 1 : 0;
+            for (std::size_t i = 0; i < pairs; ++i) levels[h + 1].push_back(level[2 * i + offset]);
+            level.erase(level.begin(), level.begin() + static_cast<std::ptrdiff_t>(2 * pairs));
+            retained -= pairs;
+            return;
+        }
+    }
+};
+
+} // namespace ariel
+
+#endif // QUANTILESKETCH_HPP
@@ -0,0 +1,493 @@
+#ifndef SORTENGINE_HPP
+#define SORTENGINE_HPP
+
+/**
+ * @file SortEngine.hpp
+ * @brief Index-sorting machinery behind MyContainer's sorted traversals.
+ * @author
+ *   <danieldaniel2468@gmail.com>
+ */
+
+#include <vector>
+#include <memory_resource>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include "IndexBuffer.hpp"
+
+namespace ariel {
+
+/**
+ * @struct identity
+ * @brief Projection that returns its argument unchanged (std::identity is C++20).
+ */
+struct identity {
+    template<typename U>
+    constexpr U&& operator()(U&& u) const noexcept { return std::forward<U>(u); }
+};
+
+/**
+ * @struct sort_key
+ * @brief Customisation point: a compact integer key summarising the order of T.
+ *
+ * Specialise with `using type = <unsigned integer>` and `static type get(const T&)`
+ * such that `a < b` implies `get(a) <= get(b)`. Keys are extracted once per
+ * element and sorted contiguously; only elements with equal keys fall back to
+ * operator<. std::string and std::string_view need none: they always use
+ * the multikey string sort.
+ *
+ * A specialisation may also declare `static constexpr bool exact = true` when
+ * `a < b` holds exactly when `get(a) < get(b)` (see pack_key()). Exact keys
+ * are radix sorted and never fall back to operator<.
+ */
+template<typename T, typename = void>
+struct sort_key {};
+
+namespace detail {
+
+// Big-endian packing of the first 8 bytes of s, zero padded: preserves lexicographic order.
+inline std::uint64_t prefix64(std::string_view s) noexcept {
+    std::uint64_t k = 0;
+    const std::size_t len = std::min<std::size_t>(s.size(), 8);
+    for (std::size_t i = 0; i < 8; ++i) {
+        k <<= 8;
+        if (i < len) k |= static_cast<unsigned char>(s[i]);
+    }
+    return k;
+}
+
+// 8-byte chunk of s starting at byte offset depth (zero padded past the end).
+inline std::uint64_t chunk64(std::string_view s, std::size_t depth) noexcept {
+    return depth < s.size() ? prefix64(s.substr(depth)) : 0;
+}
+
+template<typename T>
+constexpr bool is_string_like =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+// Introsort-style partition budget: about 2·log2(n) levels.
+inline std::size_t partitionBudget(std::size_t n) noexcept {
+    std::size_t budget = 0;
+    for (; n > 1; n >>= 1) budget += 2;
+    return budget;
+}
+
+// Multikey quicksort over 8-byte chunks: a[i] holds (chunk at depth, index).
+// Each level partitions three ways on the cached chunk; the equal part moves
+// on to the next chunk, so shared prefixes are never compared twice.
+// Small parts, and parts that exhaust their partition budget, go to std::sort
+// on the suffixes from depth, so adversarial pivots cannot go quadratic. The
+// two smaller parts recurse and the largest loops, keeping the stack O(log n).
+template<typename Vec>
+void multikeyStringSort(const Vec& data,
+                        std::pair<std::uint64_t, std::size_t>* a, std::size_t n,
+                        std::size_t depth, bool keyed, std::size_t budget) {
+    constexpr std::size_t kCutoff = 24;
+    while (n > 1) {
+        if (n < kCutoff || budget == 0) {
+            std::sort(a, a + n, [&](const auto& x, const auto& y) {
+                std::string_view sx(data[x.second]), sy(data[y.second]);
+                return sx.substr(std::min(depth, sx.size())) < sy.substr(std::min(depth, sy.size()));
+            });
+            return;
+        }
+        --budget;
+        if (!keyed) {
+            for (std::size_t i = 0; i < n; ++i) a[i].first = chunk64(data[a[i].second], depth);
+        }
+        const std::uint64_t lo = a[0].first, mid = a[n / 2].first, hi = a[n - 1].first;
+        const std::uint64_t pivot = std::max(std::min(lo, mid), std::min(std::max(lo, mid), hi));
+
+        // Dutch-flag partition: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot.
+        std::size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            if (a[i].first < pivot) std::swap(a[lt++], a[i++]);
+            else if (a[i].first > pivot) std::swap(a[i], a[--gt]);
+            else ++i;
+        }
+
+        // Within the equal part, strings ending inside this chunk sort first,
+        // ordered by length (they differ only in trailing NULs).
+        auto* eq = a + lt;
+        auto* eqEnd = a + gt;
+        auto* rest = std::partition(eq, eqEnd, [&](const auto& x) {
+            return std::string_view(data[x.second]).size() <= depth + 8;
+        });
+        std::sort(eq, rest, [&](const auto& x, const auto& y) {
+            return std::string_view(data[x.second]).size() < std::string_view(data[y.second]).size();
+        });
+
+        // The equal part consumed 8 bytes of every string, so it starts a fresh budget.
+        const std::size_t nLess = lt, nMore = n - gt, nEq = static_cast<std::size_t>(eqEnd - rest);
+        if (nEq >= nLess && nEq >= nMore) {
+            multikeyStringSort(data, a, nLess, depth, true, budget);
+            multikeyStringSort(data, a + gt, nMore, depth, true, budget);
+            a = rest;
+            n = nEq;
+            depth += 8;
+            keyed = false;
+            budget = partitionBudget(nEq);
+        } else {
+            multikeyStringSort(data, rest, nEq, depth + 8, false, partitionBudget(nEq));
+            if (nLess >= nMore) {
+                multikeyStringSort(data, a + gt, nMore, depth, true, budget);
+                n = nLess;
+            } else {
+                multikeyStringSort(data, a, nLess, depth, true, budget);
+                a += gt;
+                n = nMore;
+            }
+            keyed = true;
+        }
+    }
+}
+
+template<typename Vec>
+void stringSort(const Vec& data, IndexBuffer& order) {
+    const std::size_t n = data.size();
+    std::pmr::vector<std::pair<std::uint64_t, std::size_t>> a(n, order.resource());
+    for (std::size_t i = 0; i < n; ++i) a[i] = {0, i};
+    multikeyStringSort(data, a.data(), n, 0, false, partitionBudget(n));
+    for (std::size_t i = 0; i < n; ++i) order[i] = a[i].second;
+}
+
+template<typename T, typename = void>
+struct has_sort_key : std::false_type {};
+template<typename T>
+struct has_sort_key<T, std::void_t<typename sort_key<T>::type>> : std::true_type {};
+
+template<typename T, typename = void>
+struct has_exact_sort_key : std::false_type {};
+template<typename T>
+struct has_exact_sort_key<T, std::void_t<decltype(sort_key<T>::exact)>>
+    : std::bool_constant<sort_key<T>::exact> {};
+
+// Maps an integral field to an unsigned value of the same width with the same order.
+template<typename F>
+constexpr auto orderedBits(F v) noexcept {
+    if constexpr (std::is_enum_v<F>) {
+        return orderedBits(static_cast<std::underlying_type_t<F>>(v));
+    } else if constexpr (std::is_same_v<F, bool>) {
+        return static_cast<std::uint8_t>(v);
+    } else {
+        static_assert(std::is_integral_v<F>, "pack_key fields must be integral or enums");
+        using U = std::make_unsigned_t<F>;
+        U u = static_cast<U>(v);
+        if constexpr (std::is_signed_v<F>) u ^= U(U(1) << (std::numeric_limits<U>::digits - 1));
+        return u;
+    }
+}
+
+// Shifts k left by F's width and appends f (k is empty when F fills the whole key).
+template<typename Key, typename F>
+constexpr Key appendField(Key k, F f) noexcept {
+    if constexpr (sizeof(F) >= sizeof(Key)) return static_cast<Key>(orderedBits(f));
+    else return static_cast<Key>((k << (8 * sizeof(F))) | static_cast<Key>(orderedBits(f)));
+}
+
+// LSD radix sort of (exact key, index) pairs, one byte per pass; passes where
+// every key has the same byte are skipped. Stable.
+template<typename Vec>
+void radixKeySort(const Vec& data, IndexBuffer& order) {
+    using T = typename Vec::value_type;
+    using Key = typename sort_key<T>::type;
+    const std::size_t n = data.size();
+    std::pmr::vector<std::pair<Key, std::size_t>> a(n, order.resource()), b(n, order.resource());
+    for (std::size_t i = 0; i < n; ++i) a[i] = {sort_key<T>::get(data[i]), i};
+    auto digit = [](Key k, unsigned shift) { return static_cast<std::size_t>((k >> shift) & 0xFF); };
+    for (unsigned shift = 0; shift < 8 * sizeof(Key); shift += 8) {
+        std::size_t start[257] = {};
+        for (const auto& e : a) ++start[digit(e.first, shift) + 1];
+        if (start[digit(a[0].first, shift) + 1] == n) continue;
+        std::partial_sum(start, start + 257, start);
+        for (const auto& e : a) b[start[digit(e.first, shift)]++] = e;
+        a.swap(b);
+    }
+    for (std::size_t i = 0; i < n; ++i) order[i] = a[i].second;
+}
+
+// True when the caller asked for the natural operator< ordering of T.
+template<typename T, typename Compare, typename Projection>
+constexpr bool is_natural_order =
+    std::is_same_v<Projection, identity> &&
+    (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>);
+
+// Sorts (key, index) pairs, then resolves equal-key runs with the full comparison.
+template<typename Vec>
+void keyCachedSort(const Vec& data, IndexBuffer& order) {
+    using T = typename Vec::value_type;
+    using Key = typename sort_key<T>::type;
+    const std::size_t n = data.size();
+    std::pmr::vector<std::pair<Key, std::size_t>> keyed(n, order.resource());
+    for (std::size_t i = 0; i < n; ++i) keyed[i] = {sort_key<T>::get(data[i]), i};
+    std::sort(keyed.begin(), keyed.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (std::size_t i = 0; i < n; ++i) order[i] = keyed[i].second;
+    for (std::size_t lo = 0; lo < n;) {
+        std::size_t hi = lo + 1;
+        while (hi < n && keyed[hi].first == keyed[lo].first) ++hi;
+        if (hi - lo > 1) {
+            std::sort(order.begin() + lo, order.begin() + hi,
+                      [&](std::size_t a, std::size_t b) { return data[a] < data[b]; });
+        }
+        lo = hi;
+    }
+}
+
+// Integral types whose whole domain fits in 64K values (bool, char, int8/16, ...).
+template<typename T>
+constexpr bool is_small_domain =
+    std::is_integral_v<T> && std::numeric_limits<T>::digits <= 16;
+
+// Stable counting sort: one histogram pass over [min, max], a prefix sum, and a
+// placement pass. Returns false (order untouched) when the observed value range
+// is much wider than n, where a comparison sort is cheaper.
+template<typename Vec>
+bool countingSort(const Vec& data, IndexBuffer& order) {
+    const std::size_t n = data.size();
+    long lo = static_cast<long>(data[0]), hi = lo;
+    for (std::size_t i = 1; i < n; ++i) {
+        const long v = static_cast<long>(data[i]);
+        lo = std::min(lo, v);
+        hi = std::max(hi, v);
+    }
+    const std::size_t range = static_cast<std::size_t>(hi - lo) + 1;
+    if (range > 2 * n + 256) return false;
+    std::pmr::vector<std::size_t> start(range + 1, 0, order.resource());
+    for (std::size_t i = 0; i < n; ++i) ++start[static_cast<std::size_t>(static_cast<long>(data[i]) - lo) + 1];
+    std::partial_sum(start.begin(), start.end(), start.begin());
+    for (std::size_t i = 0; i < n; ++i) order[start[static_cast<std::size_t>(static_cast<long>(data[i]) - lo)]++] = i;
+    return true;
+}
+
+// One compare-exchange of a sorting network.
+struct Comparator {
+    std::uint8_t lo, hi;
+};
+
+// Batcher's odd-even merge sort for the next power of two >= N, keeping only
+// comparators whose both wires are < N (the dropped wires act as +infinity).
+template<std::size_t N>
+struct SortingNetwork {
+    template<typename Visit>
+    static constexpr void generate(Visit visit) {
+        std::size_t p2 = 1;
+        while (p2 < N) p2 <<= 1;
+        for (std::size_t p = 1; p < p2; p <<= 1)
+            for (std::size_t k = p; k >= 1; k >>= 1)
+                for (std::size_t j = k % p; j + k < p2; j += 2 * k)
+                    for (std::size_t i = 0; i < std::min(k, p2 - j - k); ++i)
+                        if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < N)
+                            visit(i + j, i + j + k);
+    }
+
+    static constexpr std::size_t count() {
+        std::size_t c = 0;
+        generate([&c](std::size_t, std::size_t) { ++c; });
+        return c;
+    }
+
+    static constexpr std::array<Comparator, count()> build() {
+        std::array<Comparator, count()> net{};
+        std::size_t c = 0;
+        generate([&](std::size_t lo, std::size_t hi) {
+            net[c++] = Comparator{static_cast<std::uint8_t>(lo), static_cast<std::uint8_t>(hi)};
+        });
+        return net;
+    }
+
+    static constexpr std::array<Comparator, count()> comparators = build();
+};
+
+// Branch-free compare-exchanges over the indices 0..N-1 (selects compile to cmov).
+template<std::size_t N, typename Less>
+void applyNetwork(std::size_t* o, Less& less) {
+    for (std::size_t i = 0; i < N; ++i) o[i] = i;
+    for (const Comparator c : SortingNetwork<N>::comparators) {
+        const std::size_t a = o[c.lo], b = o[c.hi];
+        const bool swap = less(b, a);
+        o[c.lo] = swap ? b : a;
+        o[c.hi] = swap ? a : b;
+    }
+}
+
+// Sorts the indices of a container with at most IndexBuffer::kInline elements.
+template<typename Less>
+void networkSort(std::size_t n, std::size_t* o, Less& less) {
+    switch (n) {
+        case 0: return;
+        case 1: o[0] = 0; return;
+        case 2: applyNetwork<2>(o, less); return;
+        case 3: applyNetwork<3>(o, less); return;
+        case 4: applyNetwork<4>(o, less); return;
+        case 5: applyNetwork<5>(o, less); return;
+        case 6: applyNetwork<6>(o, less); return;
+        case 7: applyNetwork<7>(o, less); return;
+        case 8: applyNetwork<8>(o, less); return;
+        case 9: applyNetwork<9>(o, less); return;
+        case 10: applyNetwork<10>(o, less); return;
+        case 11: applyNetwork<11>(o, less); return;
+        case 12: applyNetwork<12>(o, less); return;
+        case 13: applyNetwork<13>(o, less); return;
+        case 14: applyNetwork<14>(o, less); return;
+        case 15: applyNetwork<15>(o, less); return;
+        default: applyNetwork<16>(o, less); return;
+    }
+}
+
+// TimSort-style run detection. less(a, b) compares the elements at indices a, b.
+// Counts maximal non-descending and strictly descending runs, giving up once
+// there are more than maxRuns. When the input is made of few runs, descending
+// runs are reversed in place and the runs are merged bottom-up (stable), so a
+// sorted or reverse-sorted input costs one linear pass.
+template<typename Less>
+bool mergeRuns(std::size_t n, IndexBuffer& order, Less less) {
+    const std::size_t maxRuns = std::max<std::size_t>(2, n / 64);
+    auto runEnd = [&](std::size_t i, bool& desc) {
+        std::size_t j = i + 1;
+        desc = j < n && less(j, j - 1);
+        if (desc) while (j < n && less(j, j - 1)) ++j;
+        else      while (j < n && !less(j, j - 1)) ++j;
+        return j;
+    };
+    std::size_t runs = 0;
+    bool desc = false;
+    for (std::size_t i = 0; i < n; i = runEnd(i, desc)) {
+        if (++runs > maxRuns) return false;
+    }
+    std::pmr::vector<std::size_t> bounds(order.resource());
+    bounds.reserve(runs + 1);
+    for (std::size_t i = 0; i < n;) {
+        const std::size_t j = runEnd(i, desc);
+        bounds.push_back(i);
+        for (std::size_t k = i; k < j; ++k) order[k] = desc ? i + j - 1 - k : k;
+        i = j;
+    }
+    bounds.push_back(n);
+    if (runs == 1) return true;
+
+    IndexBuffer buf(n, order.resource());
+    while (bounds.size() > 2) {
+        std::size_t w = 0;
+        for (std::size_t r = 0; r + 1 < bounds.size(); r += 2) {
+            const std::size_t lo = bounds[r], mid = bounds[r + 1];
+            const std::size_t hi = r + 2 < bounds.size() ? bounds[r + 2] : mid;
+            std::merge(order.begin() + lo, order.begin() + mid,
+                       order.begin() + mid, order.begin() + hi, buf.begin() + lo, less);
+            bounds[w++] = lo;
+        }
+        bounds[w++] = n;
+        bounds.resize(w);
+        order.swap(buf);
+    }
+    return true;
+}
+
+// Small trivially copyable values are cheaper to move than to chase through an index.
+template<typename T>
+constexpr bool is_direct_sortable =
+    std::is_trivially_copyable_v<T> && sizeof(T) <= 16 && !std::is_same_v<T, bool>;
+
+// Sorts contiguous (value, index) pairs, so comparisons never leave the array;
+// ties are broken by index, which makes the result stable.
+template<typename Vec>
+void directSort(const Vec& data, IndexBuffer& order) {
+    using T = typename Vec::value_type;
+    const std::size_t n = data.size();
+    std::pmr::vector<std::pair<T, std::size_t>> pairs(order.resource());
+    pairs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) pairs.emplace_back(data[i], i);
+    std::sort(pairs.begin(), pairs.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+    });
+    for (std::size_t i = 0; i < n; ++i) order[i] = pairs[i].second;
+}
+
+// Multi-select: afterwards first[r - base] holds the element of rank r for every
+// r in the sorted, duplicate-free rank list [rFirst, rLast). Splitting on the
+// middle requested rank and recursing on both halves costs O(n log q) for q ranks.
+template<typename It, typename Less>
+void multiSelect(It first, It last, std::size_t base,
+                 const std::size_t* rFirst, const std::size_t* rLast, Less& less) {
+    while (rFirst != rLast && first != last) {
+        const std::size_t* mid = rFirst + (rLast - rFirst) / 2;
+        It pivot = first + static_cast<std::ptrdiff_t>(*mid - base);
+        std::nth_element(first, pivot, last, less);
+        multiSelect(first, pivot, base, rFirst, mid, less);
+        first = pivot + 1;
+        base = *mid + 1;
+        rFirst = mid + 1;
+    }
+}
+
+// Fills order with the permutation of data that is ascending under comp∘proj.
+// Scratch buffers come from order's memory resource.
+template<typename Vec, typename Compare, typename Projection>
+void sortIndices(const Vec& data, IndexBuffer& order,
+                 Compare& comp, Projection& proj) {
+    using T = typename Vec::value_type;
+    order.resize(data.size());
+    auto less = [&](std::size_t a, std::size_t b) {
+        return std::invoke(comp, std::invoke(proj, data[a]), std::invoke(proj, data[b]));
+    };
+    static_assert(IndexBuffer::kInline == 16, "networkSort covers up to 16 elements");
+    if (data.size() <= IndexBuffer::kInline) {
+        networkSort(data.size(), order.data(), less);
+        return;
+    }
+    if constexpr (is_natural_order<T, Compare, Projection> && is_small_domain<T>) {
+        if (countingSort(data, order)) return;
+    }
+    if (mergeRuns(data.size(), order, less)) return;
+    if constexpr (is_natural_order<T, Compare, Projection> && is_string_like<T>) {
+        stringSort(data, order);
+    } else if constexpr (is_natural_order<T, Compare, Projection> && has_exact_sort_key<T>::value) {
+        radixKeySort(data, order);
+    } else if constexpr (is_natural_order<T, Compare, Projection> && has_sort_key<T>::value) {
+        keyCachedSort(data, order);
+    } else if constexpr (is_natural_order<T, Compare, Projection> && is_direct_sortable<T>) {
+        directSort(data, order);
+    } else {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), less);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Pack integral fields into one order-preserving unsigned key.
+ *
+ * Fields are given most significant first and each keeps its own width, so
+ * comparing keys compares the fields lexicographically. Signed fields have
+ * their sign bit flipped. The key is 64 bits wide, or 128 bits when the
+ * fields need it (on compilers with __int128).
+ *
+ * Example: `static type get(const Point& p) { return pack_key(p.x, p.y); }`
+ */
+template<typename... F>
+constexpr auto pack_key(F... fields) noexcept {
+    constexpr std::size_t bits = (std::size_t(0) + ... + (8 * sizeof(F)));
+#ifdef __SIZEOF_INT128__
+    static_assert(bits <= 128, "pack_key: fields exceed 128 bits");
+    using Key = std::conditional_t<(bits <= 64), std::uint64_t, unsigned __int128>;
+#else
+    static_assert(bits <= 64, "pack_key: fields exceed 64 bits");
+    using Key = std::uint64_t;
+#endif
+    Key k = 0;
+    ((k = detail::appendField(k, fields)), ...);
+    return k;
+}
+
+} // namespace ariel
+
+#endif // SORTENGINE_HPP
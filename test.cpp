@@ -1,11 +1,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "MyContainer.hpp"
+#include "MyColumnContainer.hpp"
+#include "MyStaticContainer.hpp"
+#include "MyCompressedContainer.hpp"
 #include <stdexcept>
 #include <vector>
 #include <sstream>
 #include <type_traits>
 #include <utility>
+#include <thread>
+#include <numeric>
+#include <limits>
 /**
  * danieldaniel2468@gmail.com
  */
@@ -456,4 +462,1041 @@ TEST_CASE("Container copy remains independent") {
     // a still has 2, b doesn’t
     CHECK( collect(a.begin_order(), a.end_order()) == std::vector<int>{1,2,3} );
     CHECK( collect(b.begin_order(), b.end_order()) == std::vector<int>{1,3} );
-}
\ No newline at end of file
+}
+TEST_CASE("Custom comparator and projection") {
+    MyContainer<Point> pc;
+    pc.addElement({2,9});
+    pc.addElement({1,3});
+    pc.addElement({3,1});
+    // order by the y field only, no wrapper type
+    CHECK( collect(pc.begin_ascending_order(std::less<>{}, &Point::y), pc.end_ascending_order())
+           == std::vector<Point>{{3,1},{1,3},{2,9}} );
+    CHECK( collect(pc.begin_descending_order(std::less<>{}, &Point::y), pc.end_descending_order())
+           == std::vector<Point>{{2,9},{1,3},{3,1}} );
+    CHECK( collect(pc.begin_side_cross_order(std::less<>{}, &Point::y), pc.end_side_cross_order())
+           == std::vector<Point>{{3,1},{2,9},{1,3}} );
+
+    MyContainer<int> c;
+    for (int x : {7,15,6,1,2}) c.addElement(x);
+    CHECK( collect(c.begin_ascending_order(std::greater<>{}), c.end_ascending_order())
+           == std::vector<int>{15,7,6,2,1} );
+    auto byRemainder = [](int x) { return x % 5; };
+    CHECK( collect(c.begin_ascending_order(std::less<>{}, byRemainder), c.end_ascending_order()).front() == 15 );
+}
+
+TEST_CASE("removeElement with projection") {
+    MyContainer<Point> pc;
+    pc.addElement({1,2});
+    pc.addElement({2,2});
+    pc.addElement({3,4});
+    pc.removeElement(2, &Point::y);
+    CHECK( collect(pc.begin_order(), pc.end_order()) == std::vector<Point>{{3,4}} );
+    CHECK_THROWS_AS(pc.removeElement(7, &Point::x), std::runtime_error);
+}
+
+// Struct whose operator< is comparatively expensive; sort_key caches the department.
+struct Employee {
+    int dept;
+    std::string name;
+    bool operator<(const Employee& o) const {
+        return dept < o.dept || (dept == o.dept && name < o.name);
+    }
+    bool operator==(const Employee& o) const { return dept == o.dept && name == o.name; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Employee& e) {
+    return os << e.dept << ':' << e.name;
+}
+
+template<>
+struct ariel::sort_key<Employee> {
+    using type = std::uint32_t;
+    static inline std::size_t calls = 0;   // lets tests confirm the key path ran
+    static type get(const Employee& e) { ++calls; return static_cast<type>(e.dept) ^ 0x80000000u; }
+};
+
+TEST_CASE("String sort resolves prefix ties") {
+    // more than IndexBuffer::kInline elements, in many short runs, so neither the
+    // sorting networks nor run merging take the input
+    MyContainer<std::string> cs;
+    std::vector<std::string> urls = {
+        "https://example.com/b", "https://example.com/a", "http://x", "",
+        "https://example.com/a/", "https://example.co", "https://"
+    };
+    for (int i = 0; i < 30; ++i) urls.push_back("https://example.com/" + std::to_string((i * 7) % 30));
+    for (auto& u : urls) cs.addElement(u);
+    std::sort(urls.begin(), urls.end());
+    CHECK( collect(cs.begin_ascending_order(), cs.end_ascending_order()) == urls );
+}
+
+TEST_CASE("Key-cached sort resolves equal keys") {
+    MyContainer<Employee> ce;
+    std::vector<Employee> staff = {{2, "bob"}, {-1, "zed"}, {2, "amy"}, {0, "kim"}};
+    for (int i = 0; i < 40; ++i) {
+        staff.push_back({(i * 7) % 5 - 2, "e" + std::to_string((i * 13) % 40)});   // equal depts, distinct names
+    }
+    for (const auto& e : staff) ce.addElement(e);
+    std::sort(staff.begin(), staff.end());
+    const std::size_t before = ariel::sort_key<Employee>::calls;
+    CHECK( collect(ce.begin_ascending_order(), ce.end_ascending_order()) == staff );
+    CHECK( ariel::sort_key<Employee>::calls > before );
+}
+
+TEST_CASE("String sort with long shared prefixes") {
+    MyContainer<std::string> cs;
+    std::vector<std::string> paths;
+    for (int i = 0; i < 200; ++i) {
+        std::string p = "/usr/local/share/project/" + std::to_string((i * 37) % 101);
+        if (i % 7 == 0) p += std::string(1, '\0');
+        if (i % 11 == 0) p = p.substr(0, 12);
+        paths.push_back(p);
+        cs.addElement(p);
+    }
+    std::sort(paths.begin(), paths.end());
+    CHECK( collect(cs.begin_ascending_order(), cs.end_ascending_order()) == paths );
+    std::vector<std::string> rev(paths.rbegin(), paths.rend());
+    CHECK( collect(cs.begin_descending_order(), cs.end_descending_order()) == rev );
+
+    MyContainer<std::string_view> cv;
+    for (std::string_view s : {"delta", "alpha", "alphabet", "alp"}) cv.addElement(s);
+    CHECK( collect(cv.begin_side_cross_order(), cv.end_side_cross_order()) ==
+           std::vector<std::string_view>{"alp", "delta", "alpha", "alphabet"} );
+}
+
+// Distinct 8-byte strings arranged so that every median-of-3 pivot of the
+// string sort's three-way partition is the second-smallest key (McIlroy's
+// "gas" trick: undecided keys are frozen only when sampled as a pivot).
+static std::vector<std::string> medianOfThreeKiller(std::size_t n) {
+    const std::uint64_t gas = std::numeric_limits<std::uint64_t>::max();
+    std::vector<std::uint64_t> key(n, gas);
+    std::vector<std::size_t> a(n);
+    std::iota(a.begin(), a.end(), 0);
+    std::uint64_t next = 0;
+    std::size_t* p = a.data();
+    for (std::size_t len = n; len >= 24;) {
+        std::size_t frozen = 0;
+        for (std::size_t s : {p[0], p[len / 2], p[len - 1]}) frozen += key[s] != gas;
+        for (std::size_t s : {p[0], p[len / 2], p[len - 1]}) {
+            if (frozen < 2 && key[s] == gas) { key[s] = next++; ++frozen; }
+        }
+        const std::uint64_t lo = key[p[0]], mid = key[p[len / 2]], hi = key[p[len - 1]];
+        const std::uint64_t pivot = std::max(std::min(lo, mid), std::min(std::max(lo, mid), hi));
+        std::size_t lt = 0, i = 0, gt = len;
+        while (i < gt) {
+            if (key[p[i]] < pivot) std::swap(p[lt++], p[i++]);
+            else if (key[p[i]] > pivot) std::swap(p[i], p[--gt]);
+            else ++i;
+        }
+        p += gt;
+        len -= gt;
+    }
+    std::vector<std::string> out;
+    for (std::uint64_t& k : key) {
+        if (k == gas) k = next++;
+        std::string s(8, '\0');
+        for (int b = 0; b < 8; ++b) s[b] = static_cast<char>(k >> (56 - 8 * b));
+        out.push_back(s);
+    }
+    return out;
+}
+
+TEST_CASE("String sort stays O(n log n) on adversarial pivots") {
+    // without a partition budget this input needs about n/2 partition levels
+    std::vector<std::string> keys = medianOfThreeKiller(4000);
+    MyContainer<std::string> cs;
+    for (const auto& k : keys) cs.addElement(k);
+    std::sort(keys.begin(), keys.end());
+    CHECK( collect(cs.begin_ascending_order(), cs.end_ascending_order()) == keys );
+}
+
+TEST_CASE("Nearly sorted and reverse sorted input") {
+    MyContainer<int> c;
+    std::vector<int> values;
+    for (int i = 0; i < 500; ++i) values.push_back(i / 3);       // sorted, with ties
+    std::swap(values[100], values[400]);                          // a few runs
+    std::reverse(values.begin() + 200, values.begin() + 300);    // a descending run
+    for (int x : values) c.addElement(x);
+    std::sort(values.begin(), values.end());
+    CHECK( collect(c.begin_ascending_order(), c.end_ascending_order()) == values );
+
+    MyContainer<int> r;
+    for (int i = 100; i > 0; --i) r.addElement(i);
+    auto asc = collect(r.begin_ascending_order(), r.end_ascending_order());
+    CHECK( std::is_sorted(asc.begin(), asc.end()) );
+    CHECK( asc.front() == 1 );
+
+    // ties keep insertion order when merging runs
+    MyContainer<Point> pc;
+    for (int i = 0; i < 200; ++i) pc.addElement({i % 2 ? 200 - i : i, i});
+    auto byX = collect(pc.begin_ascending_order(std::less<>{}, &Point::x), pc.end_ascending_order());
+    CHECK( std::is_sorted(byX.begin(), byX.end(),
+                          [](const Point& a, const Point& b) { return a.x < b.x; }) );
+}
+
+TEST_CASE("Tiny containers of every size up to 17") {
+    for (int n = 0; n <= 17; ++n) {
+        MyContainer<int> c;
+        std::vector<int> values;
+        for (int i = 0; i < n; ++i) {
+            int x = (i * 7 + 3) % 5 - i % 3;   // unsorted, with duplicates
+            values.push_back(x);
+            c.addElement(x);
+        }
+        auto sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        CHECK( collect(c.begin_ascending_order(), c.end_ascending_order()) == sorted );
+        std::vector<int> desc(sorted.rbegin(), sorted.rend());
+        CHECK( collect(c.begin_descending_order(), c.end_descending_order()) == desc );
+        CHECK( collect(c.begin_middle_out_order(), c.end_middle_out_order()).size() == std::size_t(n) );
+        auto byNeg = collect(c.begin_ascending_order(std::greater<>{}), c.end_ascending_order());
+        CHECK( byNeg == desc );
+    }
+}
+
+TEST_CASE("Counting sort for small-domain types") {
+    MyContainer<bool> cb;
+    std::vector<bool> bits;
+    for (int i = 0; i < 100; ++i) {
+        bool b = (i * 13) % 7 < 3;
+        bits.push_back(b);
+        cb.addElement(b);
+    }
+    std::sort(bits.begin(), bits.end());
+    CHECK( collect(cb.begin_ascending_order(), cb.end_ascending_order()) == bits );
+
+    MyContainer<std::uint8_t> status;
+    MyContainer<std::int16_t> deltas;
+    std::vector<std::uint8_t> codes;
+    std::vector<std::int16_t> ds;
+    for (int i = 0; i < 300; ++i) {
+        codes.push_back(static_cast<std::uint8_t>((i * 97) % 251));
+        ds.push_back(static_cast<std::int16_t>((i * 7919) % 600 - 300));
+        status.addElement(codes.back());
+        deltas.addElement(ds.back());
+    }
+    std::sort(codes.begin(), codes.end());
+    std::sort(ds.begin(), ds.end());
+    CHECK( collect(status.begin_ascending_order(), status.end_ascending_order()) == codes );
+    CHECK( collect(deltas.begin_ascending_order(), deltas.end_ascending_order()) == ds );
+
+    // a range far wider than n falls back to comparison sorting
+    MyContainer<std::int16_t> sparse;
+    for (int i = 0; i < 20; ++i) sparse.addElement(static_cast<std::int16_t>(i % 2 ? 30000 - i : -30000 + i));
+    auto sp = collect(sparse.begin_ascending_order(), sparse.end_ascending_order());
+    CHECK( std::is_sorted(sp.begin(), sp.end()) );
+}
+
+TEST_CASE("Direct value sort and sorted_values") {
+    MyContainer<double> cd;
+    std::vector<double> ds;
+    for (int i = 0; i < 1000; ++i) {
+        double x = ((i * 7919) % 1009) / 7.0;
+        ds.push_back(x);
+        cd.addElement(x);
+    }
+    std::sort(ds.begin(), ds.end());
+    CHECK( collect(cd.begin_ascending_order(), cd.end_ascending_order()) == ds );
+    CHECK( cd.sorted_values() == ds );
+
+    MyContainer<Point> pc;
+    std::vector<Point> ps;
+    for (int i = 0; i < 100; ++i) {
+        Point p{(i * 31) % 17, (i * 13) % 5};
+        ps.push_back(p);
+        pc.addElement(p);
+    }
+    std::sort(ps.begin(), ps.end());
+    CHECK( collect(pc.begin_ascending_order(), pc.end_ascending_order()) == ps );
+    CHECK( pc.sorted_values() == ps );
+
+    MyContainer<int> empty;
+    CHECK( empty.sorted_values().empty() );
+}
+
+// Lexicographic struct whose fields pack into one exact 128-bit key.
+struct Version {
+    int major, minor, patch;
+    bool operator<(const Version& o) const {
+        if (major != o.major) return major < o.major;
+        if (minor != o.minor) return minor < o.minor;
+        return patch < o.patch;
+    }
+    bool operator==(const Version& o) const {
+        return major == o.major && minor == o.minor && patch == o.patch;
+    }
+};
+
+std::ostream& operator<<(std::ostream& os, const Version& v) {
+    return os << v.major << '.' << v.minor << '.' << v.patch;
+}
+
+template<>
+struct ariel::sort_key<Version> {
+    using type = decltype(pack_key(0, 0, 0));
+    static constexpr bool exact = true;
+    static type get(const Version& v) { return pack_key(v.major, v.minor, v.patch); }
+};
+
+static_assert(pack_key(-1, 5) < pack_key(0, 0), "signed fields keep their order");
+static_assert(pack_key(std::int16_t(1), std::uint8_t(0)) > pack_key(std::int16_t(0), std::uint8_t(255)),
+              "earlier fields are more significant");
+
+TEST_CASE("Packed composite keys") {
+    MyContainer<Version> cv;
+    std::vector<Version> vs;
+    for (int i = 0; i < 300; ++i) {
+        Version v{(i * 7) % 5 - 2, (i * 11) % 13, -((i * 3) % 7)};
+        vs.push_back(v);
+        cv.addElement(v);
+    }
+    std::sort(vs.begin(), vs.end());
+    CHECK( collect(cv.begin_ascending_order(), cv.end_ascending_order()) == vs );
+    auto cross = collect(cv.begin_side_cross_order(), cv.end_side_cross_order());
+    CHECK( cross.front() == vs.front() );
+    CHECK( cross[1] == vs.back() );
+}
+
+template<>
+struct ariel::field_traits<Point> {
+    static constexpr auto fields = std::make_tuple(&Point::x, &Point::y);
+};
+
+TEST_CASE("Column container stores fields separately") {
+    MyColumnContainer<Point> pc;
+    pc.addElement({3,1});
+    pc.addElement({1,7});
+    pc.addElement({2,4});
+    pc.addElement({1,7});
+    CHECK(pc.size() == 4);
+    CHECK( pc.column<0>() == std::vector<int>{3,1,2,1} );
+    CHECK( pc.column<1>() == std::vector<int>{1,7,4,7} );
+    CHECK( collect(pc.begin_order(), pc.end_order()) ==
+           std::vector<Point>{{3,1},{1,7},{2,4},{1,7}} );
+
+    // order by y, reading only the y column; field<0>() is a view of x
+    std::vector<int> xs;
+    for (auto it = pc.begin_ascending_by<1>(); it != pc.end_ascending_by(); ++it) {
+        xs.push_back(it.field<0>());
+    }
+    CHECK( xs == std::vector<int>{3,2,1,1} );
+    CHECK( *pc.begin_ascending_by<0>(std::greater<>{}) == Point{3,1} );
+
+    pc.removeElement({1,7});
+    CHECK( collect(pc.begin_order(), pc.end_order()) == std::vector<Point>{{3,1},{2,4}} );
+    CHECK_THROWS_AS(pc.removeElement({9,9}), std::runtime_error);
+    CHECK_THROWS_AS(pc.element(2), std::out_of_range);
+
+    std::ostringstream os;
+    os << pc;
+    CHECK( os.str() == "[ (3,1) (2,4) ]" );
+}
+
+struct Job {
+    int id;
+    bool done;
+    bool operator==(const Job& o) const { return id == o.id && done == o.done; }
+};
+
+std::ostream& operator<<(std::ostream& os, const Job& j) {
+    return os << j.id << (j.done ? "+" : "-");
+}
+
+template<>
+struct ariel::field_traits<Job> {
+    static constexpr auto fields = std::make_tuple(&Job::id, &Job::done);
+};
+
+TEST_CASE("Column container with a bool field") {
+    MyColumnContainer<Job> jobs;
+    for (int i = 0; i < 20; ++i) jobs.addElement({i, i % 3 == 0});
+    std::vector<int> ids;
+    std::vector<bool> flags;
+    for (auto it = jobs.begin_ascending_by<1>(); it != jobs.end_ascending_by(); ++it) {
+        flags.push_back(it.field<1>());
+        ids.push_back(it.field<0>());
+    }
+    CHECK( std::is_sorted(flags.begin(), flags.end()) );
+    CHECK( std::count(flags.begin(), flags.end(), true) == 7 );
+    CHECK( ids.front() == 1 );
+    CHECK( ids.back() == 18 );
+}
+
+// Memory resource that tracks outstanding bytes, forwarding to the global heap.
+class CountingResource : public std::pmr::memory_resource {
+public:
+    std::size_t allocations = 0;
+    std::size_t outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        ++allocations;
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& o) const noexcept override {
+        return this == &o;
+    }
+};
+
+TEST_CASE("Storage and ordering buffers use the given memory resource") {
+    CountingResource counter;
+    {
+        MyContainer<std::string> c(&counter);
+        CHECK(c.get_resource() == &counter);
+        for (int i = 0; i < 100; ++i) c.addElement(std::to_string((i * 37) % 100));
+        const std::size_t afterInserts = counter.allocations;
+        auto asc = collect(c.begin_ascending_order(), c.end_ascending_order());
+        auto cross = collect(c.begin_side_cross_order(), c.end_side_cross_order());
+        CHECK(asc.size() == 100);
+        CHECK(cross.size() == 100);
+        CHECK(counter.allocations > afterInserts);   // permutation and scratch buffers
+    }
+    CHECK(counter.outstanding == 0);
+
+    // an arena with no upstream: everything must fit in the buffer
+    alignas(std::max_align_t) unsigned char arena[16384];
+    std::pmr::monotonic_buffer_resource mono(arena, sizeof(arena), std::pmr::null_memory_resource());
+    MyContainer<int> a(&mono);
+    for (int x : {5,3,8,1,9,2,7,4,6,0,15,11,13,12,14,10,16,20,18,17}) a.addElement(x);
+    auto v = collect(a.begin_descending_order(), a.end_descending_order());
+    CHECK(v.front() == 20);
+    CHECK(v.back() == 0);
+}
+
+TEST_CASE("Inline storage for short containers") {
+    CountingResource counter;
+    MyContainer<int, 8> c(&counter);
+    for (int x : {7,15,6,1,2,9,4,3}) c.addElement(x);
+    CHECK(counter.allocations == 0);
+    CHECK( collect(c.begin_ascending_order(), c.end_ascending_order()) ==
+           std::vector<int>{1,2,3,4,6,7,9,15} );
+    CHECK( collect(c.begin_middle_out_order(), c.end_middle_out_order()).size() == 8 );
+    CHECK(counter.allocations == 0);
+
+    c.addElement(0);                      // overflow spills to the resource
+    CHECK(counter.allocations == 1);
+    CHECK( collect(c.begin_descending_order(), c.end_descending_order()).back() == 0 );
+
+    MyContainer<int, 8> copy = c;        // copies keep their own inline slot
+    copy.removeElement(15);
+    CHECK(c.size() == 9);
+    CHECK(copy.size() == 8);
+
+    MyContainer<int, 8> moved = std::move(copy);
+    CHECK( collect(moved.begin_order(), moved.end_order()) ==
+           std::vector<int>{7,6,1,2,9,4,3,0} );
+    CHECK(copy.size() == 0);
+    moved = c;
+    CHECK( collect(moved.begin_reverse_order(), moved.end_reverse_order()).front() == 0 );
+
+    const std::size_t beforeFlags = counter.allocations;
+    MyContainer<bool, 8> flags(&counter);   // vector<bool> asks for whole words
+    for (bool f : {true, false, true, true, false}) flags.addElement(f);
+    CHECK( collect(flags.begin_ascending_order(), flags.end_ascending_order()) ==
+           std::vector<bool>{false, false, true, true, true} );
+    CHECK(counter.allocations == beforeFlags);
+
+    MyContainer<std::string, 4> s;
+    s.addElement("b");
+    s.addElement("a");
+    std::ostringstream os;
+    os << s;
+    CHECK( os.str() == "[ b a ]" );
+}
+
+TEST_CASE("Recycled permutation buffers") {
+    auto* pool = ariel::detail::bufferResource(std::pmr::new_delete_resource());
+    CHECK(pool != std::pmr::new_delete_resource());
+    void* a = pool->allocate(1000 * sizeof(std::size_t), alignof(std::size_t));
+    pool->deallocate(a, 1000 * sizeof(std::size_t), alignof(std::size_t));
+    void* b = pool->allocate(900 * sizeof(std::size_t), alignof(std::size_t));   // same size class
+    CHECK(a == b);
+    pool->deallocate(b, 900 * sizeof(std::size_t), alignof(std::size_t));
+
+    // retention is bounded per thread and can be released
+    using Pool = ariel::detail::RecyclingResource;
+    std::vector<void*> blocks;
+    for (int i = 0; i < 8; ++i) blocks.push_back(pool->allocate(std::size_t(1) << Pool::kMaxShift, 8));
+    for (void* p : blocks) pool->deallocate(p, std::size_t(1) << Pool::kMaxShift, 8);
+    CHECK(Pool::retained_bytes() <= Pool::kMaxRetainedBytes);
+    CHECK(Pool::retained_bytes() > 0);
+    Pool::trim();
+    CHECK(Pool::retained_bytes() == 0);
+
+    // user-supplied resources are never replaced
+    CountingResource counter;
+    CHECK(ariel::detail::bufferResource(&counter) == &counter);
+
+    MyContainer<int> c;
+    for (int i = 0; i < 1000; ++i) c.addElement((i * 7919) % 1009);
+    auto first = collect(c.begin_ascending_order(), c.end_ascending_order());
+    auto again = collect(c.begin_ascending_order(), c.end_ascending_order());
+    CHECK(first == again);
+    CHECK(std::is_sorted(first.begin(), first.end()));
+}
+
+// Orders of a constexpr container are computed by the compiler.
+constexpr MyStaticContainer<int, 8> kTable{7, 15, 6, 1, 2};
+static_assert(kTable.size() == 5);
+static_assert(kTable.ascending_order()[0] == 3 && kTable.ascending_order()[4] == 1);
+static_assert(kTable.side_cross_order()[1] == 1);       // 15 is second
+static_assert(kTable.middle_out_order()[0] == 2);       // 6 is the middle
+static_assert(*kTable.begin_descending_order() == 15);
+
+constexpr MyStaticContainer<int, 8> withoutOnes() {
+    MyStaticContainer<int, 8> c{3, 1, 4, 1, 5};
+    c.removeElement(1);
+    c.addElement(0);
+    return c;
+}
+static_assert(withoutOnes().size() == 4);
+static_assert(withoutOnes().at(withoutOnes().ascending_order()[0]) == 0);
+
+TEST_CASE("Static container orders match MyContainer") {
+    MyContainer<int> dyn;
+    for (int x : {7,15,6,1,2}) dyn.addElement(x);
+    CHECK( collect(kTable.begin_ascending_order(), kTable.end_ascending_order()) ==
+           collect(dyn.begin_ascending_order(), dyn.end_ascending_order()) );
+    CHECK( collect(kTable.begin_descending_order(), kTable.end_descending_order()) ==
+           collect(dyn.begin_descending_order(), dyn.end_descending_order()) );
+    CHECK( collect(kTable.begin_side_cross_order(), kTable.end_side_cross_order()) ==
+           collect(dyn.begin_side_cross_order(), dyn.end_side_cross_order()) );
+    CHECK( collect(kTable.begin_reverse_order(), kTable.end_reverse_order()) ==
+           collect(dyn.begin_reverse_order(), dyn.end_reverse_order()) );
+    CHECK( collect(kTable.begin_order(), kTable.end_order()) ==
+           collect(dyn.begin_order(), dyn.end_order()) );
+    CHECK( collect(kTable.begin_middle_out_order(), kTable.end_middle_out_order()) ==
+           collect(dyn.begin_middle_out_order(), dyn.end_middle_out_order()) );
+
+    MyStaticContainer<int, 2> small{1, 2};
+    CHECK_THROWS_AS(small.addElement(3), std::length_error);
+    CHECK_THROWS_AS(small.removeElement(9), std::runtime_error);
+    std::ostringstream os;
+    os << small;
+    CHECK( os.str() == "[ 1 2 ]" );
+}
+
+TEST_CASE("Order statistics: nth_smallest, rank, median") {
+    MyContainer<int> c;
+    std::vector<int> values;
+    for (int i = 0; i < 101; ++i) {
+        int x = (i * 37) % 101;        // a permutation of 0..100
+        values.push_back(x);
+        c.addElement(x);
+    }
+    // no cached order yet: selection
+    CHECK(c.nth_smallest(0) == 0);
+    CHECK(c.nth_smallest(99) == 99);
+    CHECK(c.median() == 50);
+    CHECK(c.rank(40) == 40);
+    CHECK(c.rank(1000) == 101);
+
+    // building an ascending iterator caches the order; answers are unchanged
+    CHECK(*c.begin_ascending_order() == 0);
+    CHECK(c.nth_smallest(42) == 42);
+    CHECK(c.rank(-5) == 0);
+    CHECK(c.median() == 50);
+
+    // appending a new maximum keeps the cache, anything else rebuilds it
+    c.addElement(500);
+    CHECK(c.nth_smallest(101) == 500);
+    c.addElement(-1);
+    CHECK(c.nth_smallest(0) == -1);
+    CHECK(c.rank(500) == 102);
+    c.removeElement(500);
+    CHECK(c.nth_smallest(101) == 100);
+
+    CHECK_THROWS_AS(c.nth_smallest(102), std::out_of_range);
+    MyContainer<int> empty;
+    CHECK_THROWS_AS(empty.median(), std::out_of_range);
+    CHECK(empty.rank(3) == 0);
+
+    MyContainer<std::string> s;
+    for (const char* w : {"pear", "apple", "fig", "kiwi"}) s.addElement(w);
+    CHECK(s.median() == "fig");
+    CHECK(s.rank("banana") == 1);
+}
+
+TEST_CASE("Value-range iteration on the ascending order") {
+    MyContainer<int> c;
+    for (int x : {7,15,6,1,2,9,6,12}) c.addElement(x);
+    std::vector<int> got;
+    for (int x : c.ascending_range(2, 9)) got.push_back(x);
+    CHECK( got == std::vector<int>{2,6,6,7,9} );
+    CHECK( c.ascending_range(2, 9).size() == 5 );
+
+    got.clear();
+    for (int x : c.descending_range(6, 100)) got.push_back(x);
+    CHECK( got == std::vector<int>{15,12,9,7,6,6} );
+
+    CHECK( c.ascending_range(3, 5).empty() );      // nothing between 3 and 5
+    CHECK( c.ascending_range(9, 2).empty() );      // inverted bounds
+    CHECK( c.descending_range(20, 30).empty() );
+    auto all = c.ascending_range(-100, 100);
+    CHECK( std::vector<int>(all.begin(), all.end()).size() == c.size() );
+
+    MyContainer<std::string> words;
+    for (const char* w : {"delta", "alpha", "charlie", "bravo", "echo"}) words.addElement(w);
+    std::vector<std::string> ws;
+    for (const auto& w : words.ascending_range("b", "d")) ws.push_back(w);
+    CHECK( ws == std::vector<std::string>{"bravo", "charlie"} );
+}
+
+TEST_CASE("top_k and bottom_k") {
+    MyContainer<int> c;
+    std::vector<int> values;
+    for (int i = 0; i < 200; ++i) {
+        int x = (i * 53) % 97;        // duplicates included
+        values.push_back(x);
+        c.addElement(x);
+    }
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<int> rsorted(sorted.rbegin(), sorted.rend());
+
+    for (std::size_t k : {0, 1, 5, 12, 150, 200, 500}) {   // heap and selection paths
+        std::vector<int> lo, hi;
+        c.bottom_k(k, std::back_inserter(lo));
+        c.top_k(k, std::back_inserter(hi));
+        std::size_t m = std::min<std::size_t>(k, sorted.size());
+        CHECK( lo == std::vector<int>(sorted.begin(), sorted.begin() + m) );
+        CHECK( hi == std::vector<int>(rsorted.begin(), rsorted.begin() + m) );
+    }
+
+    // with a cached order the answers come straight from it
+    CHECK(*c.begin_ascending_order() == 0);
+    std::vector<int> three(3);
+    c.top_k(3, three.begin());
+    CHECK( three == std::vector<int>(rsorted.begin(), rsorted.begin() + 3) );
+    c.bottom_k(3, three.begin());
+    CHECK( three == std::vector<int>(sorted.begin(), sorted.begin() + 3) );
+}
+
+TEST_CASE("page in every traversal") {
+    MyContainer<int> c;
+    for (int i = 0; i < 37; ++i) c.addElement((i * 29) % 41 - 10);   // unsorted, no cache yet
+
+    auto check = [&](Traversal t, const std::vector<int>& full) {
+        for (std::size_t size : {1, 4, 10}) {
+            for (std::size_t p = 0; p * size < full.size(); ++p) {
+                std::size_t last = std::min(full.size(), (p + 1) * size);
+                CHECK( c.page(t, p, size) == std::vector<int>(full.begin() + p * size, full.begin() + last) );
+            }
+            CHECK( c.page(t, (full.size() + size - 1) / size, size).empty() );
+        }
+    };
+    auto all = [&]() {
+        return std::vector<std::vector<int>>{
+            collect(c.begin_ascending_order(), c.end_ascending_order()),
+            collect(c.begin_descending_order(), c.end_descending_order()),
+            collect(c.begin_side_cross_order(), c.end_side_cross_order()),
+            collect(c.begin_reverse_order(), c.end_reverse_order()),
+            collect(c.begin_order(), c.end_order()),
+            collect(c.begin_middle_out_order(), c.end_middle_out_order())};
+    };
+    const Traversal orders[] = {Traversal::Ascending, Traversal::Descending, Traversal::SideCross,
+                                Traversal::Reverse, Traversal::Insertion, Traversal::MiddleOut};
+    MyContainer<int> fresh = c;          // copy made before anything is cached
+    auto expected = all();
+    for (std::size_t i = 0; i < 6; ++i) {
+        std::swap(c, fresh);             // selection path
+        check(orders[i], expected[i]);
+        std::swap(c, fresh);             // cached path
+        check(orders[i], expected[i]);
+    }
+    CHECK( c.page(Traversal::Ascending, 0, 0).empty() );
+    CHECK( c.page(Traversal::Insertion, 0, std::size_t(-1)) == expected[4] );   // no wrap-around
+    CHECK( c.page(Traversal::Insertion, 1, std::size_t(-1)).empty() );
+    CHECK( c.page(Traversal::Descending, 1, std::size_t(-1) / 2 + 1).empty() );
+    CHECK( MyContainer<int>().page(Traversal::SideCross, 0, 5).empty() );
+}
+
+TEST_CASE("quantiles and strided sampling") {
+    MyContainer<int> c;
+    std::vector<int> values;
+    for (int i = 0; i < 1001; ++i) {
+        int x = (i * 389) % 500;      // every value twice, one thrice
+        values.push_back(x);
+        c.addElement(x);
+    }
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<double> qs = {0.99, 0.0, 0.5, 0.25, 1.0, 0.5};   // unsorted, repeated
+    std::vector<int> expected;
+    for (double q : qs) expected.push_back(sorted[static_cast<std::size_t>(q * 1000)]);
+    std::vector<int> stride;
+    for (std::size_t r = 0; r < sorted.size(); r += 100) stride.push_back(sorted[r]);
+
+    CHECK( c.quantiles(qs) == expected );          // multi-select
+    CHECK( c.sample_every(100) == stride );
+    CHECK( c.sample_every(std::size_t(-1)) == std::vector<int>{sorted[0]} );
+    CHECK(*c.begin_ascending_order() == sorted[0]);
+    CHECK( c.quantiles(qs) == expected );          // cached order
+    CHECK( c.sample_every(1) == sorted );
+
+    CHECK_THROWS_AS(c.quantiles({1.5}), std::out_of_range);
+    CHECK_THROWS_AS(c.sample_every(0), std::invalid_argument);
+    CHECK_THROWS_AS(MyContainer<int>().quantiles({0.5}), std::out_of_range);
+    CHECK( MyContainer<int>().sample_every(3).empty() );
+}
+
+TEST_CASE("approximate quantile sketch") {
+    MyContainer<int> c;
+    CHECK_FALSE(c.has_sketch());
+    CHECK_THROWS_AS(c.approx_rank(1), std::logic_error);
+    for (int i = 0; i < 1000; ++i) c.addElement(i);
+    c.enable_sketch();                                   // picks up existing elements
+    for (int i = 1000; i < 100000; ++i) c.addElement((i * 7919) % 100000);
+    const double n = static_cast<double>(c.size());
+    const double tol = 3 * QuantileSketch<int>(200).error_bound();
+
+    for (double q : {0.01, 0.5, 0.9, 0.99}) {
+        int v = c.approx_quantile(q);
+        CHECK( std::abs(static_cast<double>(c.rank(v)) / n - q) <= tol );
+        CHECK( std::abs(c.approx_rank(v) - static_cast<double>(c.rank(v))) / n <= tol );
+    }
+
+    // removals are subtracted via a second sketch
+    MyContainer<int> shuffled;
+    shuffled.enable_sketch();
+    for (int i = 0; i < 20000; ++i) shuffled.addElement((i * 7919) % 20000);
+    MyContainer<int> d = shuffled;                       // copies carry the sketch
+    REQUIRE(d.has_sketch());
+    for (int i = 0; i < 10000; ++i) d.removeElement(i);
+    for (double q : {0.1, 0.5, 0.99}) {
+        int v = d.approx_quantile(q);
+        CHECK( v >= 10000 );
+        CHECK( std::abs(static_cast<double>(d.rank(v)) / d.size() - q) <= 1.5 * tol );
+    }
+
+    // heavy removal: the error is relative to what is left, not to all updates
+    for (int i = 10000; i < 19000; ++i) d.removeElement(i);
+    for (double q : {0.1, 0.5, 0.99}) {
+        int v = d.approx_quantile(q);
+        CHECK( v >= 19000 );
+        CHECK( std::abs(static_cast<double>(d.rank(v)) / d.size() - q) <= 1.5 * tol );
+        CHECK( std::abs(d.approx_rank(v) - static_cast<double>(d.rank(v))) / d.size() <= 1.5 * tol );
+    }
+    MyContainer<int> bulk = shuffled;                    // one call removing 95%
+    bulk.removeElement(true, [](int x) { return x < 19000; });
+    CHECK( bulk.approx_quantile(0.1) >= 19000 );
+    CHECK( std::abs(static_cast<double>(bulk.rank(bulk.approx_quantile(0.5))) / bulk.size() - 0.5) <= 1.5 * tol );
+
+    MyContainer<int> e = std::move(d);
+    CHECK(e.has_sketch());
+    CHECK_THROWS_AS(e.approx_quantile(1.5), std::out_of_range);
+    CHECK(QuantileSketch<int>::k_for_error(0.01) > 200);
+
+    // the sketch lives on the container's resource; repeated queries reuse one table
+    CountingResource counter;
+    {
+        MyContainer<int> onCounter(&counter);
+        onCounter.enable_sketch(64);
+        for (int i = 0; i < 3000; ++i) onCounter.addElement((i * 31) % 1000);
+        onCounter.removeElement(7);
+        const std::size_t beforeQuery = counter.allocations;
+        int p50 = onCounter.approx_quantile(0.5);
+        const std::size_t afterFirst = counter.allocations;
+        CHECK(afterFirst > beforeQuery);                 // table built from the resource
+        CHECK(onCounter.approx_quantile(0.5) == p50);
+        CHECK(onCounter.approx_quantile(0.99) >= p50);
+        CHECK(counter.allocations == afterFirst);        // later queries allocate nothing
+        onCounter.addElement(5);
+        onCounter.approx_quantile(0.5);
+        CHECK(counter.allocations > afterFirst);         // modification dropped the table
+    }
+    CHECK(counter.outstanding == 0);
+
+    // sketches built separately merge into one
+    QuantileSketch<int> a, b;
+    for (int i = 0; i < 5000; ++i) { a.update(i); b.update(i + 5000); }
+    a.merge(b);
+    CHECK(a.count() == 10000);
+    CHECK( std::abs(a.rank(5000) - 5000.0) <= tol * 10000 );
+}
+
+TEST_CASE("ascending groups of duplicates") {
+    MyContainer<int> c;
+    for (int x : {5, 2, 5, 9, 2, 5, 1}) c.addElement(x);
+
+    std::vector<std::pair<int, std::size_t>> counts;
+    std::vector<std::vector<std::size_t>> where;
+    for (const auto& g : c.ascending_groups()) {
+        counts.emplace_back(g.value, g.count);
+        std::vector<std::size_t> idx(g.first, g.last);
+        std::sort(idx.begin(), idx.end());
+        where.push_back(idx);
+    }
+    CHECK( counts == std::vector<std::pair<int, std::size_t>>{{1, 1}, {2, 2}, {5, 3}, {9, 1}} );
+    CHECK( where == std::vector<std::vector<std::size_t>>{{6}, {1, 4}, {0, 2, 5}, {3}} );
+
+    MyContainer<bool> flags;
+    for (int i = 0; i < 40; ++i) flags.addElement(i % 4 == 0);
+    std::vector<std::pair<bool, std::size_t>> flagCounts;
+    for (const auto& g : flags.ascending_groups()) flagCounts.emplace_back(g.value, g.count);
+    CHECK( flagCounts == std::vector<std::pair<bool, std::size_t>>{{false, 30}, {true, 10}} );
+
+    MyContainer<int> empty;
+    CHECK( empty.ascending_groups().empty() );
+    CHECK( empty.ascending_groups().begin() == empty.ascending_groups().end() );
+}
+
+TEST_CASE("MyCompressedContainer matches MyContainer in every order") {
+    MyContainer<int> plain;
+    MyCompressedContainer<int> packed;
+    for (int i = 0; i < 301; ++i) {
+        int status = (i * 7) % 5 == 0 ? 404 : (i % 3 == 0 ? 500 : 200);
+        plain.addElement(status);
+        packed.addElement(status);
+    }
+    CHECK(packed.size() == plain.size());
+    CHECK(packed.distinct_count() == 3);
+    CHECK(packed.count(404) + packed.count(500) + packed.count(200) == packed.size());
+    CHECK(packed.count(7) == 0);
+
+    auto same = [&]() {
+        CHECK( collect(packed.begin_ascending_order(), packed.end_ascending_order())
+               == collect(plain.begin_ascending_order(), plain.end_ascending_order()) );
+        CHECK( collect(packed.begin_descending_order(), packed.end_descending_order())
+               == collect(plain.begin_descending_order(), plain.end_descending_order()) );
+        CHECK( collect(packed.begin_side_cross_order(), packed.end_side_cross_order())
+               == collect(plain.begin_side_cross_order(), plain.end_side_cross_order()) );
+        CHECK( collect(packed.begin_reverse_order(), packed.end_reverse_order())
+               == collect(plain.begin_reverse_order(), plain.end_reverse_order()) );
+        CHECK( collect(packed.begin_order(), packed.end_order())
+               == collect(plain.begin_order(), plain.end_order()) );
+        CHECK( collect(packed.begin_middle_out_order(), packed.end_middle_out_order())
+               == collect(plain.begin_middle_out_order(), plain.end_middle_out_order()) );
+    };
+    same();
+
+    packed.removeElement(404);      // middle-aged slot: later slots are renumbered
+    plain.removeElement(404);
+    packed.addElement(100);
+    plain.addElement(100);
+    same();
+
+    std::ostringstream a, b;
+    a << packed;
+    b << plain;
+    CHECK(a.str() == b.str());
+    CHECK_THROWS_AS(packed.removeElement(404), std::runtime_error);
+
+    MyContainer<bool> plainFlags;
+    MyCompressedContainer<bool> packedFlags;
+    for (int i = 0; i < 50; ++i) {
+        plainFlags.addElement(i % 7 == 3);
+        packedFlags.addElement(i % 7 == 3);
+    }
+    CHECK(packedFlags.distinct_count() == 2);
+    CHECK( collect(packedFlags.begin_ascending_order(), packedFlags.end_ascending_order())
+           == collect(plainFlags.begin_ascending_order(), plainFlags.end_ascending_order()) );
+    CHECK( collect(packedFlags.begin_descending_order(), packedFlags.end_descending_order())
+           == collect(plainFlags.begin_descending_order(), plainFlags.end_descending_order()) );
+    CHECK( collect(packedFlags.begin_side_cross_order(), packedFlags.end_side_cross_order())
+           == collect(plainFlags.begin_side_cross_order(), plainFlags.end_side_cross_order()) );
+    CHECK( collect(packedFlags.begin_middle_out_order(), packedFlags.end_middle_out_order())
+           == collect(plainFlags.begin_middle_out_order(), plainFlags.end_middle_out_order()) );
+    CHECK_THROWS_AS(*packed.end_order(), std::out_of_range);
+}
+
+TEST_CASE("set operations over cached orders") {
+    MyContainer<int> a, b;
+    std::vector<int> va, vb;
+    for (int i = 0; i < 120; ++i) {
+        va.push_back((i * 37) % 50);       // values repeat, so multiset semantics matter
+        vb.push_back((i * 11) % 70 + 20);
+    }
+    for (int x : va) a.addElement(x);
+    for (int x : vb) b.addElement(x);
+    std::sort(va.begin(), va.end());
+    std::sort(vb.begin(), vb.end());
+
+    auto expect = [&](auto algo) {
+        std::vector<int> out;
+        algo(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(out));
+        return out;
+    };
+    auto view = [](auto v) { return std::vector<int>(v.begin(), v.end()); };
+    using It = std::vector<int>::iterator;
+    using Out = std::back_insert_iterator<std::vector<int>>;
+    CHECK( view(a.intersection_with(b)) == expect(std::set_intersection<It, It, Out>) );
+    CHECK( view(a.union_with(b)) == expect(std::set_union<It, It, Out>) );
+    CHECK( view(a.difference_with(b)) == expect(std::set_difference<It, It, Out>) );
+    CHECK( view(a.symmetric_difference_with(b)) == expect(std::set_symmetric_difference<It, It, Out>) );
+
+    MyContainer<int> none;
+    CHECK( a.intersection_with(none).empty() );
+    CHECK( view(none.union_with(b)) == vb );
+    CHECK( a.difference_with(a).empty() );
+    CHECK( view(a.intersection_with(a)) == va );
+}
+
+TEST_CASE("merge keeps a valid sorted cache") {
+    MyContainer<int> a, b;
+    std::vector<int> all;
+    for (int i = 0; i < 150; ++i) { a.addElement((i * 31) % 97); all.push_back((i * 31) % 97); }
+    for (int i = 0; i < 90; ++i) { b.addElement((i * 17) % 61); all.push_back((i * 17) % 61); }
+    a.enable_sketch();
+    b.enable_sketch();
+    CHECK(*a.begin_ascending_order() == 0);     // a cached, b not: both paths feed the merge
+
+    a.merge(std::move(b));
+    CHECK(a.size() == 240);
+    CHECK(b.size() == 0);
+    CHECK_FALSE(b.has_sketch());
+    CHECK( collect(a.begin_order(), a.end_order()) == all );   // insertion order: a, then b
+    std::sort(all.begin(), all.end());
+    CHECK( a.sorted_values() == all );
+    CHECK( collect(a.begin_ascending_order(), a.end_ascending_order()) == all );
+    CHECK( a.nth_smallest(120) == all[120] );
+    CHECK( std::abs(a.approx_rank(50) - static_cast<double>(a.rank(50))) <= 10 );
+
+    MyContainer<int> sorted1, sorted2;
+    for (int i = 0; i < 5; ++i) { sorted1.addElement(i); sorted2.addElement(i + 5); }
+    sorted1.merge(std::move(sorted2));
+    CHECK( collect(sorted1.begin_ascending_order(), sorted1.end_ascending_order())
+           == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9} );
+    b.addElement(3);                              // a moved-from container is reusable
+    sorted1.merge(std::move(b));
+    CHECK(sorted1.nth_smallest(4) == 3);
+    CHECK_THROWS_AS(a.merge(std::move(a)), std::invalid_argument);
+}
+
+TEST_CASE("split_by_pivots") {
+    std::vector<int> values;
+    for (int i = 0; i < 200; ++i) values.push_back((i * 43) % 101);
+    const std::vector<int> pivots = {10, 50, 50, 90};
+
+    for (bool cached : {false, true}) {
+        MyContainer<int> c;
+        for (int x : values) c.addElement(x);
+        if (cached) CHECK(*c.begin_ascending_order() == 0);
+
+        auto parts = c.split_by_pivots(pivots);
+        CHECK(c.size() == 0);
+        REQUIRE(parts.size() == 5);
+        CHECK(parts[2].size() == 0);                    // between equal pivots
+        std::size_t total = 0;
+        for (std::size_t p = 0; p < parts.size(); ++p) {
+            std::vector<int> expected;
+            for (int x : values) {
+                bool lo = p == 0 || !(x < pivots[p - 1]);
+                bool hi = p == pivots.size() || x < pivots[p];
+                if (lo && hi) expected.push_back(x);
+            }
+            CHECK( collect(parts[p].begin_order(), parts[p].end_order()) == expected );
+            std::sort(expected.begin(), expected.end());
+            CHECK( collect(parts[p].begin_ascending_order(), parts[p].end_ascending_order()) == expected );
+            total += parts[p].size();
+        }
+        CHECK(total == values.size());
+    }
+
+    MyContainer<int> c;
+    c.addElement(1);
+    CHECK_THROWS_AS(c.split_by_pivots({5, 3}), std::invalid_argument);
+    CHECK(c.size() == 1);
+    CHECK(c.split_by_pivots({}).front().size() == 1);
+}
+
+TEST_CASE("k-way merged view across containers") {
+    std::vector<MyContainer<int>> shards(7);
+    std::vector<int> all;
+    for (int i = 0; i < 500; ++i) {
+        int x = (i * 71) % 113;
+        shards[static_cast<std::size_t>(i % 6)].addElement(x);   // shard 6 stays empty
+        all.push_back(x);
+    }
+    std::vector<const MyContainer<int>*> ptrs;
+    for (const auto& s : shards) ptrs.push_back(&s);
+    ptrs.push_back(nullptr);
+
+    auto asc = MyContainer<int>::merged_ascending(ptrs);
+    auto desc = MyContainer<int>::merged_descending(ptrs);
+    std::sort(all.begin(), all.end());
+    CHECK( std::vector<int>(asc.begin(), asc.end()) == all );
+    std::reverse(all.begin(), all.end());
+    CHECK( std::vector<int>(desc.begin(), desc.end()) == all );
+
+    MyContainer<bool> f1, f2;
+    for (int i = 0; i < 10; ++i) { f1.addElement(i % 2 == 0); f2.addElement(i % 5 == 0); }
+    auto flags = MyContainer<bool>::merged_descending({&f1, &f2});
+    std::vector<bool> merged(flags.begin(), flags.end());
+    CHECK( merged.size() == 20 );
+    CHECK( std::count(merged.begin(), merged.end(), true) == 7 );
+    CHECK( std::is_sorted(merged.rbegin(), merged.rend()) );
+
+    auto none = MyContainer<int>::merged_ascending({});
+    CHECK( none.begin() == none.end() );
+    CHECK_THROWS_AS(*none.begin(), std::out_of_range);
+}
+
+TEST_CASE("order cache is allocated on first use") {
+    // resource, sortedness flag, cache pointer and sketch pointer around the vector
+    static_assert(sizeof(MyContainer<int>) <= sizeof(std::pmr::vector<int>) + 4 * sizeof(void*));
+    static_assert(sizeof(MyContainer<std::string>) == sizeof(MyContainer<int>));
+
+    CountingResource counter;
+    {
+        MyContainer<int> c(&counter);
+        for (int x : {4, 1, 3}) c.addElement(x);
+        const std::size_t afterInserts = counter.allocations;
+        CHECK( collect(c.begin_order(), c.end_order()) == std::vector<int>{4, 1, 3} );
+        CHECK(counter.allocations == afterInserts);           // unsorted traversals need no cache
+        CHECK( collect(c.begin_ascending_order(), c.end_ascending_order()) == std::vector<int>{1, 3, 4} );
+        CHECK(counter.allocations == afterInserts + 1);       // the cache itself
+        MyContainer<int> moved = std::move(c);                // the cache changes hands
+        CHECK(moved.nth_smallest(0) == 1);
+        CHECK(counter.allocations == afterInserts + 1);
+    }
+    CHECK(counter.outstanding == 0);
+}
+
+TEST_CASE("containers keep their resource when a vector of them grows") {
+    static_assert(std::is_nothrow_move_constructible_v<MyContainer<int>>);
+    static_assert(std::is_nothrow_move_constructible_v<MyContainer<std::string>>);
+
+    std::pmr::monotonic_buffer_resource mono;
+    std::vector<MyContainer<int>> shards;
+    for (int i = 0; i < 9; ++i) {
+        shards.emplace_back(&mono);                 // several reallocations
+        shards.back().addElement(3 - i);
+        shards.back().addElement(i);
+        CHECK(*shards.back().begin_ascending_order() == std::min(3 - i, i));
+    }
+    for (const auto& s : shards) CHECK(s.get_resource() == &mono);
+    CHECK(shards.front().median() == 0);
+}
+
+TEST_CASE("concurrent const use fills the cache once") {
+    MyContainer<int> c;
+    std::vector<int> values;
+    for (int i = 0; i < 5000; ++i) { values.push_back((i * 7919) % 5003); c.addElement(values.back()); }
+    std::sort(values.begin(), values.end());
+    const MyContainer<int>& shared = c;
+
+    std::vector<int> medians(8), firsts(8), mins(8);
+    std::vector<std::size_t> ranged(8);
+    std::vector<std::thread> readers;
+    for (std::size_t t = 0; t < 8; ++t) {
+        readers.emplace_back([&, t] {
+            medians[t] = shared.median();
+            firsts[t] = *shared.begin_ascending_order();
+            mins[t] = shared.nth_smallest(0);
+            ranged[t] = shared.ascending_range(100, 199).size();
+        });
+    }
+    for (auto& r : readers) r.join();
+    for (std::size_t t = 0; t < 8; ++t) {
+        CHECK(medians[t] == values[(values.size() - 1) / 2]);
+        CHECK(firsts[t] == values.front());
+        CHECK(mins[t] == values.front());
+        CHECK(ranged[t] == 100);
+    }
+}